@@ -0,0 +1,118 @@
+#include "Analytics.h"
+#include "globals.h"
+#include <iostream>
+#include <cstdlib>
+using namespace std;
+
+Analytics::Analytics(int nRows, int nCols, int bucketTurns, int nBuckets)
+{
+	if (nRows <= 0 || nCols <= 0 || nRows > MAXROWS || nCols > MAXCOLS ||
+		bucketTurns <= 0 || nBuckets < 2)
+	{
+		cout << "***** Analytics created with invalid size!" << endl;
+		exit(1);
+	}
+	m_rows = nRows;
+	m_cols = nCols;
+	m_bucketTurns = bucketTurns;
+	m_nBuckets = nBuckets;
+	m_turn = 0;
+	m_running.assign(NUMHEATMAPS * nRows * nCols, 0);
+	m_snapshots.assign(static_cast<size_t>(nBuckets) * NUMHEATMAPS * nRows * nCols, 0);
+}
+
+int Analytics::turn() const
+{
+	return m_turn;
+}
+
+void Analytics::record(int kind, int r, int c)
+{
+	if (kind < 0 || kind >= NUMHEATMAPS || r < 1 || r > m_rows || c < 1 || c > m_cols)
+		return;
+	m_running[(kind * m_rows + r - 1) * m_cols + c - 1]++;
+}
+
+void Analytics::endTurn()
+{
+	// At each bucket boundary, keep a copy of the totals so far,
+	// overwriting the oldest one
+	m_turn++;
+	if (m_turn % m_bucketTurns != 0)
+		return;
+	size_t size = m_running.size();
+	size_t slot = static_cast<size_t>(m_turn / m_bucketTurns % m_nBuckets) * size;
+	for (size_t k = 0; k < size; k++)
+		m_snapshots[slot + k] = m_running[k];
+}
+
+const unsigned int* Analytics::totalsAt(int turn) const
+{
+	// Totals as of the start of turn, which must be now or a bucket
+	// boundary still in the ring; nullptr otherwise
+	if (turn == m_turn)
+		return m_running.data();
+	if (turn < 0 || turn > m_turn || turn % m_bucketTurns != 0 ||
+		turn / m_bucketTurns <= m_turn / m_bucketTurns - m_nBuckets)
+		return nullptr;
+	return &m_snapshots[static_cast<size_t>(turn / m_bucketTurns % m_nBuckets) * m_running.size()];
+}
+
+bool Analytics::heatmap(int kind, int fromTurn, int toTurn, unsigned int counts[]) const
+{
+	// Fill counts[(r-1)*cols + (c-1)] with the events of this kind in
+	// turns fromTurn up to (not including) toTurn.  The window is
+	// widened to bucket boundaries (toTurn is capped at the current
+	// turn); returns false if its start has already left the ring.
+	if (kind < 0 || kind >= NUMHEATMAPS || fromTurn > toTurn)
+		return false;
+	if (toTurn >= m_turn)
+		toTurn = m_turn;
+	else
+		toTurn = (toTurn + m_bucketTurns - 1) / m_bucketTurns * m_bucketTurns;
+	if (toTurn > m_turn)
+		toTurn = m_turn;
+	if (fromTurn < 0)
+		fromTurn = 0;
+	fromTurn = fromTurn / m_bucketTurns * m_bucketTurns;
+
+	const unsigned int* from = totalsAt(fromTurn);
+	const unsigned int* to = totalsAt(toTurn);
+	if (from == nullptr || to == nullptr)
+		return false;
+	int cells = m_rows * m_cols;
+	from += kind * cells;
+	to += kind * cells;
+	for (int k = 0; k < cells; k++)
+		counts[k] = to[k] - from[k];
+	return true;
+}
+
+
+bool Analytics::render(ostream& out, int kind, int fromTurn, int toTurn) const
+{
+	// Draw heatmap's window as a grid, like History::render, but with
+	// the letters scaled to the busiest cell: 'Z' is the most events,
+	// 'A' the fewest above none, '.' none at all
+	vector<unsigned int> counts(m_rows * m_cols);
+	if (!heatmap(kind, fromTurn, toTurn, counts.data()))
+		return false;
+	unsigned int most = 0;
+	for (size_t k = 0; k < counts.size(); k++)
+		if (counts[k] > most)
+			most = counts[k];
+	for (int r = 0; r < m_rows; r++)
+	{
+		for (int c = 0; c < m_cols; c++)
+		{
+			unsigned long long n = counts[r * m_cols + c];
+			if (n == 0)
+				out << '.';
+			else
+				out << static_cast<char>('A' + (n - 1) * 26 / most);
+		}
+		out << endl;
+	}
+	out << endl;
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#ifndef ANALYTICS_H
+
+#define ANALYTICS_H
+
+#include <iosfwd>
+#include <vector>
+
+// Kinds of events Analytics counts per cell
+const int HEAT_VISITS = 0;          // a live player ended a turn here
+const int HEAT_SNAKEDEATHS = 1;     // a snake was killed here
+const int HEAT_PLAYERDEATHS = 2;    // a player died here
+const int NUMHEATMAPS = 3;
+
+// Per-cell event counts that can be asked for any window of recent
+// turns.  Rather than a log of every turn, it keeps running totals plus
+// a ring of nBuckets snapshots of those totals, one every bucketTurns
+// turns; the counts for a window are the difference of two snapshots,
+// so a query costs O(cells) however long the window.  Turns are counted
+// from when recording started.
+class Analytics
+{
+public:
+	// Constructor
+	Analytics(int nRows, int nCols, int bucketTurns, int nBuckets);
+
+	// Accessors
+	int  turn() const;
+	bool heatmap(int kind, int fromTurn, int toTurn, unsigned int counts[]) const;
+	bool render(std::ostream& out, int kind, int fromTurn, int toTurn) const;
+
+	// Mutators
+	void record(int kind, int r, int c);
+	void endTurn();
+
+private:
+	int m_rows;
+	int m_cols;
+	int m_bucketTurns;
+	int m_nBuckets;
+	int m_turn;
+	std::vector<unsigned int> m_running;    // [kind][cell] totals so far
+	std::vector<unsigned int> m_snapshots;  // [bucket][kind][cell] totals at bucket starts
+
+	const unsigned int* totalsAt(int turn) const;
+};
+
+#endif
@@ -0,0 +1,362 @@
+#include "BatchEnv.h"
+#include "Pit.h"
+#include "Player.h"
+#include "CompactGame.h"
+#include "globals.h"
+#include "GlobalHistory.h"
+#include "History.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <new>
+using namespace std;
+
+namespace
+{
+	// All environments live in one contiguous array of Pits and are
+	// stepped in place by a fixed pool of threads, each taking its own
+	// slice of the array.  Pits small enough for a CompactGame are
+	// CompactGames instead: the same games in a few percent of the memory.
+	class BatchEnv
+	{
+	public:
+		BatchEnv();
+		~BatchEnv();
+
+		bool configure(int rows, int cols, int nSnakes, bool hunting);
+		int  obsSize() const;
+		bool reset(int nEnvs, const unsigned long long* seeds, unsigned char* obsOut);
+		void step(const int* actions, unsigned char* obsOut, float* rewardOut,
+			unsigned char* doneOut);
+		void killHeatmap(unsigned long long* countsOut, bool clear);
+		void close();
+
+	private:
+		int   m_rows;
+		int   m_cols;
+		int   m_nSnakes;
+		bool  m_hunting;
+		Pit*  m_pits;
+		CompactGame* m_games;  // instead of m_pits for small pits
+		int   m_nEnvs;
+		vector<unsigned long long> m_seeds;  // seed of each env's next game
+		GlobalHistory  m_kills;               // every env's History, summed
+		unsigned int*  m_callerKills;         // kills buffer for the calling thread
+
+		// Arguments of the call being run by the pool
+		const int*     m_actions;
+		unsigned char* m_obsOut;
+		float*         m_rewardOut;
+		unsigned char* m_doneOut;
+		void (BatchEnv::*m_job)(int);
+
+		vector<thread>     m_threads;
+		int                m_nThreads;  // including the caller's
+		mutex              m_mutex;
+		condition_variable m_wake;
+		condition_variable m_finished;
+		unsigned long      m_generation;
+		int                m_busy;
+		bool               m_stopping;
+
+		void startGame(int k);
+		void resetOne(int k);
+		void stepOne(int k);
+		void writeObs(int k);
+		void runSlice(int t, int nThreads);
+		void runAll(void (BatchEnv::*job)(int));
+		void worker(int t, unsigned long seen);
+		void destroyPits();
+	};
+
+	BatchEnv::BatchEnv()
+	{
+		m_rows = 9;
+		m_cols = 10;
+		m_nSnakes = 15;
+		m_hunting = false;
+		m_pits = nullptr;
+		m_games = nullptr;
+		m_nEnvs = 0;
+		m_callerKills = nullptr;
+		m_nThreads = 1;
+		m_generation = 0;
+		m_busy = 0;
+		m_stopping = false;
+	}
+
+	BatchEnv::~BatchEnv()
+	{
+		close();
+	}
+
+	bool BatchEnv::configure(int rows, int cols, int nSnakes, bool hunting)
+	{
+		if (rows <= 0 || cols <= 0 || rows > MAXROWS || cols > MAXCOLS ||
+			nSnakes < 0 || nSnakes > MAXSNAKES || nSnakes >= rows * cols)
+			return false;
+		destroyPits();
+		m_rows = rows;
+		m_cols = cols;
+		m_nSnakes = nSnakes;
+		m_hunting = hunting;
+		return true;
+	}
+
+	int BatchEnv::obsSize() const
+	{
+		return NUMOBSPLANES * m_rows * m_cols;
+	}
+
+	void BatchEnv::startGame(int k)
+	{
+		// Same setup as Game::Game, in a pit (or CompactGame) constructed
+		// with this env's seed, so each env is reproducible from its seed
+		// and no pool thread calls rand()
+		if (m_games != nullptr)
+			new (&m_games[k]) CompactGame(m_rows, m_cols, m_nSnakes, m_seeds[k], m_hunting);
+		else
+		{
+			Pit* pit = new (&m_pits[k]) Pit(m_rows, m_cols, m_seeds[k]);
+			pit->setHunting(m_hunting);
+			int rPlayer = 1 + pit->randInt(m_rows);
+			int cPlayer = 1 + pit->randInt(m_cols);
+			pit->addPlayer(rPlayer, cPlayer);
+			pit->spawnSnakes(m_nSnakes, rPlayer, cPlayer);
+		}
+
+		// The next game of this env gets a different, but still
+		// deterministic, seed
+		m_seeds[k] = m_seeds[k] * 6364136223846793005ULL + 1442695040888963407ULL;
+	}
+
+	void BatchEnv::resetOne(int k)
+	{
+		startGame(k);
+		if (m_obsOut != nullptr)
+			writeObs(k);
+	}
+
+	void BatchEnv::stepOne(int k)
+	{
+		int action = m_actions[k];
+		int snakesBefore;
+		int snakesAfter;
+		bool dead;
+		if (m_games != nullptr)
+		{
+			CompactGame& game = m_games[k];
+			snakesBefore = game.snakeCount();
+			if (action >= UP && action <= RIGHT)
+				game.move(action);
+			else
+				game.stand();
+			if (!game.isDead())
+				game.moveSnakes();
+			snakesAfter = game.snakeCount();
+			dead = game.isDead();
+		}
+		else
+		{
+			Pit* pit = &m_pits[k];
+			Player* p = pit->player();
+			snakesBefore = pit->snakeCount();
+			if (action >= UP && action <= RIGHT)
+				p->move(action);
+			else
+				p->stand();
+			if (!p->isDead())
+				pit->moveSnakes();
+			snakesAfter = pit->snakeCount();
+			dead = p->isDead();
+		}
+
+		float reward = static_cast<float>(snakesBefore - snakesAfter);
+		if (dead)
+			reward -= 1;
+		bool done = dead || snakesAfter == 0;
+		if (m_rewardOut != nullptr)
+			m_rewardOut[k] = reward;
+		if (m_doneOut != nullptr)
+			m_doneOut[k] = done;
+		if (done)
+		{
+			if (m_pits != nullptr)
+				m_pits[k].~Pit();
+			startGame(k);
+		}
+		if (m_obsOut != nullptr)
+			writeObs(k);
+	}
+
+	void BatchEnv::writeObs(int k)
+	{
+		unsigned char* out = m_obsOut + static_cast<size_t>(k) * obsSize();
+		if (m_games != nullptr)
+			m_games[k].exportObservation(out, m_rows * m_cols, m_cols);
+		else
+			m_pits[k].exportObservation(out, m_rows * m_cols, m_cols);
+	}
+
+	bool BatchEnv::reset(int nEnvs, const unsigned long long* seeds, unsigned char* obsOut)
+	{
+		if (nEnvs <= 0)
+			return false;
+		destroyPits();
+		if (m_rows * m_cols <= MAXCOMPACTCELLS)
+			m_games = static_cast<CompactGame*>(::operator new(static_cast<size_t>(nEnvs) * sizeof(CompactGame)));
+		else
+			m_pits = static_cast<Pit*>(::operator new(static_cast<size_t>(nEnvs) * sizeof(Pit)));
+		m_nEnvs = nEnvs;
+		m_seeds.assign(nEnvs, 0);
+		for (int k = 0; k < nEnvs; k++)
+			m_seeds[k] = (seeds != nullptr ? seeds[k] : k);
+		m_obsOut = obsOut;
+		runAll(&BatchEnv::resetOne);
+		return true;
+	}
+
+	void BatchEnv::step(const int* actions, unsigned char* obsOut, float* rewardOut,
+		unsigned char* doneOut)
+	{
+		if (m_pits == nullptr && m_games == nullptr)
+			return;
+		m_actions = actions;
+		m_obsOut = obsOut;
+		m_rewardOut = rewardOut;
+		m_doneOut = doneOut;
+		runAll(&BatchEnv::stepOne);
+	}
+
+	void BatchEnv::killHeatmap(unsigned long long* countsOut, bool clear)
+	{
+		// Workers are idle between calls, so their buffers are safe to fold
+		m_kills.merge();
+		for (int r = 1; r <= m_rows; r++)
+			for (int c = 1; c <= m_cols; c++)
+				countsOut[(r - 1) * m_cols + (c - 1)] = m_kills.timesAt(r, c);
+		if (clear)
+			m_kills.clear();
+	}
+
+	void BatchEnv::runSlice(int t, int nThreads)
+	{
+		int begin = static_cast<int>(static_cast<long long>(m_nEnvs) * t / nThreads);
+		int end = static_cast<int>(static_cast<long long>(m_nEnvs) * (t + 1) / nThreads);
+		for (int k = begin; k < end; k++)
+			(this->*m_job)(k);
+	}
+
+	void BatchEnv::runAll(void (BatchEnv::*job)(int))
+	{
+		// Small batches aren't worth waking anyone up for
+		const int ENVSPERTHREAD = 64;
+		m_job = job;
+		if (m_threads.empty() && m_nEnvs > ENVSPERTHREAD)
+		{
+			int n = static_cast<int>(thread::hardware_concurrency());
+			if (n > m_nEnvs / ENVSPERTHREAD)
+				n = m_nEnvs / ENVSPERTHREAD;
+			if (n > 1)
+				m_nThreads = n;
+			for (int t = 1; t < m_nThreads; t++)
+				m_threads.push_back(thread(&BatchEnv::worker, this, t, m_generation));
+		}
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_busy = m_nThreads - 1;
+			m_generation++;
+		}
+		m_wake.notify_all();
+		if (m_callerKills == nullptr)
+			m_callerKills = m_kills.newBuffer();
+		unsigned int* callersOwn = History::setThreadTotals(m_callerKills);
+		runSlice(0, m_nThreads);
+		History::setThreadTotals(callersOwn);
+		unique_lock<mutex> lock(m_mutex);
+		m_finished.wait(lock, [this] { return m_busy == 0; });
+	}
+
+	void BatchEnv::worker(int t, unsigned long seen)
+	{
+		History::setThreadTotals(m_kills.newBuffer());
+		for (;;)
+		{
+			{
+				unique_lock<mutex> lock(m_mutex);
+				m_wake.wait(lock, [&] { return m_stopping || m_generation != seen; });
+				if (m_stopping)
+					return;
+				seen = m_generation;
+			}
+			runSlice(t, m_nThreads);
+			{
+				lock_guard<mutex> lock(m_mutex);
+				m_busy--;
+			}
+			m_finished.notify_one();
+		}
+	}
+
+	void BatchEnv::destroyPits()
+	{
+		// CompactGames have nothing to destroy
+		if (m_pits != nullptr)
+			for (int k = 0; k < m_nEnvs; k++)
+				m_pits[k].~Pit();
+		::operator delete(m_pits);
+		::operator delete(m_games);
+		m_pits = nullptr;
+		m_games = nullptr;
+		m_nEnvs = 0;
+	}
+
+	void BatchEnv::close()
+	{
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_stopping = true;
+		}
+		m_wake.notify_all();
+		for (size_t t = 0; t < m_threads.size(); t++)
+			m_threads[t].join();
+		m_threads.clear();
+		m_nThreads = 1;
+		m_stopping = false;
+		destroyPits();
+	}
+
+	BatchEnv theBatch;
+}
+
+int snakepit_configure(int rows, int cols, int nSnakes, int hunting)
+{
+	return theBatch.configure(rows, cols, nSnakes, hunting != 0);
+}
+
+int snakepit_obs_size(void)
+{
+	return theBatch.obsSize();
+}
+
+int snakepit_reset(int nEnvs, const unsigned long long* seeds, unsigned char* obsOut)
+{
+	return theBatch.reset(nEnvs, seeds, obsOut);
+}
+
+void snakepit_step(const int* actions, unsigned char* obsOut, float* rewardOut,
+	unsigned char* doneOut)
+{
+	theBatch.step(actions, obsOut, rewardOut, doneOut);
+}
+
+void snakepit_kill_heatmap(unsigned long long* countsOut, int clear)
+{
+	theBatch.killHeatmap(countsOut, clear != 0);
+}
+
+void snakepit_close(void)
+{
+	theBatch.close();
+}
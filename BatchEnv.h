@@ -0,0 +1,38 @@
+#ifndef BATCHENV_H
+
+#define BATCHENV_H
+
+// C interface for stepping many independent games at once, for training
+// agents.  Build it as a shared library (see README).  All environments
+// share one size and snake count, set by snakepit_configure.
+//
+// Actions are 0..3 for UP, DOWN, LEFT, RIGHT (see globals.h); anything
+// else stands still.  The reward is the number of snakes the player
+// killed that step, minus 1 if the player died.  An environment whose
+// game ended reports done and is immediately restarted, so the
+// observation written for it is the first one of its next game.
+//
+// Each observation is snakepit_obs_size() bytes: the NUMOBSPLANES
+// rows x cols planes of Pit::exportObservation (snake counts, player,
+// kill history), one after the other.
+//
+// snakepit_kill_heatmap writes the rows x cols kills summed over every
+// game played so far, and optionally starts the sums over.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int  snakepit_configure(int rows, int cols, int nSnakes, int hunting);
+int  snakepit_obs_size(void);
+int  snakepit_reset(int nEnvs, const unsigned long long* seeds, unsigned char* obsOut);
+void snakepit_step(const int* actions, unsigned char* obsOut, float* rewardOut,
+	unsigned char* doneOut);
+void snakepit_kill_heatmap(unsigned long long* countsOut, int clear);
+void snakepit_close(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
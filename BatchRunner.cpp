@@ -0,0 +1,76 @@
+#include "BatchRunner.h"
+#include "globals.h"
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <thread>
+#include <algorithm>
+using namespace std;
+
+namespace
+{
+	// The z with a two-sided normal tail of 1 - confidence, found by
+	// bisection since <cmath> has erfc but not its inverse
+	double zFor(double confidence)
+	{
+		double lo = 0;
+		double hi = 40;
+		for (int k = 0; k < 100; k++)
+		{
+			double mid = (lo + hi) / 2;
+			if (erfc(mid / sqrt(2.0)) > 1 - confidence)
+				lo = mid;
+			else
+				hi = mid;
+		}
+		return (lo + hi) / 2;
+	}
+
+	void wilson(SurvivalEstimate& e, double z)
+	{
+		double n = static_cast<double>(e.games);
+		double p = e.survived / n;
+		double z2n = z * z / n;
+		double center = (p + z2n / 2) / (1 + z2n);
+		double half = z / (1 + z2n) * sqrt(p * (1 - p) / n + z2n / (4 * n));
+		e.rate = p;
+		e.low = max(0.0, center - half);
+		e.high = min(1.0, center + half);
+	}
+}
+
+BatchRunner::BatchRunner(int rows, int cols, int nSnakes, bool hunting, int nThreads)
+{
+	if (rows <= 0 || cols <= 0 || rows > MAXROWS || cols > MAXCOLS)
+	{
+		cout << "***** BatchRunner created with invalid size " << rows << " by "
+			<< cols << "!" << endl;
+		exit(1);
+	}
+	// The same games Game accepts: snakes may share cells, but not the
+	// player's only cell
+	if (nSnakes < 0 || nSnakes > MAXSNAKES || (rows == 1 && cols == 1 && nSnakes > 0))
+	{
+		cout << "***** Cannot create BatchRunner with " << nSnakes << " snakes in a "
+			<< rows << " by " << cols << " pit!" << endl;
+		exit(1);
+	}
+	m_rows = rows;
+	m_cols = cols;
+	m_nSnakes = nSnakes;
+	m_hunting = hunting;
+	if (nThreads <= 0)
+		nThreads = static_cast<int>(thread::hardware_concurrency());
+	m_nThreads = (nThreads > 0 ? nThreads : 1);
+}
+
+int BatchRunner::threadCount() const
+{
+	return m_nThreads;
+}
+
+void BatchRunner::score(SurvivalEstimate& e, double confidence, double halfWidth)
+{
+	wilson(e, zFor(confidence));
+	e.converged = (e.high - e.low) / 2 <= halfWidth;
+}
@@ -0,0 +1,150 @@
+#ifndef BATCHRUNNER_H
+
+#define BATCHRUNNER_H
+
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include "PitFactory.h"
+#include "Policy.h"
+
+// How often a policy's player survived, with the Wilson score interval
+// around that rate
+struct SurvivalEstimate
+{
+	long   games;
+	long   survived;
+	double rate;
+	double low;
+	double high;
+	bool   converged;  // the interval got as narrow as was asked for
+};
+
+// Estimates the chance that a policy's player survives maxTurns turns
+// of a headless game, or kills every snake first; quitting counts as
+// not surviving.  Games are played in waves spread over the runner's
+// threads; after each wave the Wilson interval of all the games so far
+// is checked, and play stops as soon as it is within halfWidth of the
+// rate, so easy estimates take few games.  Each game gets its own copy
+// of the policy, and game k is set up (and the policy started) from
+// seed + k, so the result doesn't depend on the number of threads.  A
+// policy that can play on any kind of pit is played through withPit,
+// on a FixedPit where there is one; its games are the same either way.
+class BatchRunner
+{
+public:
+	// Constructor
+	BatchRunner(int rows, int cols, int nSnakes, bool hunting = false, int nThreads = 0);
+
+	// Accessors
+	int threadCount() const;
+	template <typename Policy>
+	SurvivalEstimate estimate(const Policy& policy, int maxTurns, double halfWidth,
+	                          double confidence = 0.95, long maxGames = 1000000,
+	                          int waveSize = 256, unsigned long long seed = 1) const;
+
+private:
+	int  m_rows;
+	int  m_cols;
+	int  m_nSnakes;
+	bool m_hunting;
+	int  m_nThreads;
+
+	static void score(SurvivalEstimate& e, double confidence, double halfWidth);
+	template <typename Policy>
+	bool survives(Policy policy, int maxTurns, unsigned long long seed) const;
+	template <typename Policy, typename PitType>
+	static bool playsOut(Policy& policy, PitType& pit, int maxTurns, unsigned long long seed);
+	template <typename Policy>
+	long playWave(const Policy& policy, int maxTurns, unsigned long long seed, int nGames) const;
+};
+
+template <typename Policy>
+SurvivalEstimate BatchRunner::estimate(const Policy& policy, int maxTurns, double halfWidth,
+	double confidence, long maxGames, int waveSize, unsigned long long seed) const
+{
+	SurvivalEstimate e;
+	e.games = 0;
+	e.survived = 0;
+	e.rate = 0;
+	e.low = 0;
+	e.high = 1;
+	e.converged = false;
+	if (waveSize < 1)
+		waveSize = 1;
+	while (!e.converged && e.games < maxGames)
+	{
+		int nGames = static_cast<int>(std::min<long>(waveSize, maxGames - e.games));
+		e.survived += playWave(policy, maxTurns, seed + e.games, nGames);
+		e.games += nGames;
+		score(e, confidence, halfWidth);
+	}
+	return e;
+}
+
+template <typename Policy>
+bool BatchRunner::survives(Policy policy, int maxTurns, unsigned long long seed) const
+{
+	// A policy that can play on any kind of pit gets a FixedPit if
+	// there is one of this size
+	if constexpr (requires (Policy& q, FixedPit<9, 10, MAXSNAKES>& fixed) { q.choose(fixed); })
+	{
+		return withPit(m_rows, m_cols, m_nSnakes, m_hunting, seed, [&](auto& pit) {
+			return playsOut(policy, pit, maxTurns, seed);
+		});
+	}
+	else
+	{
+		Pit pit(m_rows, m_cols, seed);  // rand() isn't safe on worker threads
+		startPitOrExit(pit, m_nSnakes, m_hunting, seed);
+		return playsOut(policy, pit, maxTurns, seed);
+	}
+}
+
+template <typename Policy, typename PitType>
+bool BatchRunner::playsOut(Policy& policy, PitType& pit, int maxTurns, unsigned long long seed)
+{
+	policy.start(seed);
+	auto* p = pit.player();
+	for (int turn = 0; turn < maxTurns && pit.snakeCount() > 0; turn++)
+	{
+		int move = policy.choose(pit);
+		if (move == QUIT)
+			return false;
+		if (move == STAND)
+			p->stand();
+		else if (move >= UP && move <= RIGHT)
+			p->move(move);
+		pit.moveSnakes();
+		if (p->isDead())
+			return false;
+	}
+	return true;
+}
+
+template <typename Policy>
+long BatchRunner::playWave(const Policy& policy, int maxTurns, unsigned long long seed, int nGames) const
+{
+	// Plays games seed .. seed+nGames-1, each thread taking its own
+	// slice, and returns how many the player survived
+	int nThreads = std::min(m_nThreads, nGames);
+	std::atomic<long> survived(0);
+	auto playSlice = [&](int t) {
+		int begin = static_cast<int>(static_cast<long long>(nGames) * t / nThreads);
+		int end = static_cast<int>(static_cast<long long>(nGames) * (t + 1) / nThreads);
+		long n = 0;
+		for (int k = begin; k < end; k++)
+			n += survives(policy, maxTurns, seed + k);
+		survived += n;
+	};
+	std::vector<std::thread> threads;
+	for (int t = 1; t < nThreads; t++)
+		threads.push_back(std::thread(playSlice, t));
+	playSlice(0);
+	for (size_t t = 0; t < threads.size(); t++)
+		threads[t].join();
+	return survived;
+}
+
+#endif
@@ -0,0 +1,257 @@
+#include "Benchmark.h"
+#include "Game.h"
+#include "Pit.h"
+#include "Player.h"
+#include "Policy.h"
+#include "Analytics.h"
+#include "globals.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <new>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+using namespace std;
+
+namespace
+{
+#ifdef COUNTALLOCATIONS
+	// Every allocation made through operator new anywhere in the
+	// program; counting costs one relaxed increment.  Only bench builds
+	// define COUNTALLOCATIONS (see README), so a plain build allocates
+	// through the library's own operator new.
+	atomic<unsigned long long> allocations(0);
+	const bool COUNTSALLOCATIONS = true;
+#else
+	atomic<unsigned long long> allocations(0);  // stays 0
+	const bool COUNTSALLOCATIONS = false;
+#endif
+
+	const char SCRIPT[] = "ur.dl.rrd.lu";  // the scripted player's moves
+	const char* const PLAYERNAMES[] = { "scripted", "standing", "advancing" };
+	const int  MAXGAMETURNS = 10000;        // a game that lasts longer is cut off
+	const int  ANALYTICSBUCKETTURNS = 100;  // of a scenario's Analytics
+	const int  ANALYTICSBUCKETS = 64;
+
+	enum { CHOOSE, PLAYER, SNAKES, RENDER, NUMPHASES };
+	const char* const PHASENAMES[NUMPHASES] = { "choose", "player", "snakes", "render" };
+
+	double nsSince(chrono::steady_clock::time_point start)
+	{
+		return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+	}
+}
+
+#ifdef COUNTALLOCATIONS
+void* operator new(size_t size)
+{
+	allocations.fetch_add(1, memory_order_relaxed);
+	void* p = malloc(size > 0 ? size : 1);
+	if (p == nullptr)
+		throw bad_alloc();
+	return p;
+}
+
+void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	free(p);
+}
+#endif
+
+Benchmark::Benchmark(unsigned long long seed, long minTurns)
+{
+	m_seed = seed;
+	m_minTurns = (minTurns > 0 ? minTurns : 1);
+}
+
+bool Benchmark::addScenario(int rows, int cols, int nSnakes, bool render, int resortInterval,
+                            PlayerKind player, bool analytics)
+{
+	// Only games that Game itself would accept; advance renders nothing
+	if (rows < 1 || rows > MAXROWS || cols < 1 || cols > MAXCOLS ||
+			nSnakes < 0 || nSnakes > MAXSNAKES || (rows == 1 && cols == 1 && nSnakes > 0) ||
+			resortInterval < 0 || (render && player == ADVANCING))
+		return false;
+	Scenario s;
+	s.rows = rows;
+	s.cols = cols;
+	s.nSnakes = nSnakes;
+	s.render = render;
+	s.resortInterval = resortInterval;
+	s.player = player;
+	s.analytics = analytics;
+	m_scenarios.push_back(s);
+	return true;
+}
+
+void Benchmark::addDefaultScenarios()
+{
+	// From the mini-game in main.cpp, through the default game, to the
+	// largest pit, each without and then with rendering; the largest
+	// pit again with Morton resorting, against the unsorted run; a
+	// standing player turn by turn and then through Pit::advance; and
+	// the default game and the largest pit with analytics recording
+	static const int sizes[][3] = {
+		{ 3, 3, 2 }, { 9, 10, 15 }, { 10, 20, 40 }, { 20, 40, 100 }, { 20, 40, 180 }
+	};
+	for (const auto& size : sizes)
+	{
+		addScenario(size[0], size[1], size[2], false);
+		addScenario(size[0], size[1], size[2], true);
+	}
+	addScenario(20, 40, 180, false, 16);
+	addScenario(20, 40, 40, false, 0, STANDING);
+	addScenario(20, 40, 40, false, 0, ADVANCING);
+	addScenario(9, 10, 15, false, 0, SCRIPTED, true);
+	addScenario(20, 40, 180, false, 0, SCRIPTED, true);
+}
+
+bool Benchmark::run(ostream& out)
+{
+	out << "{\"seed\": " << m_seed << ", \"minTurns\": " << m_minTurns << ", \"scenarios\": [";
+	for (size_t k = 0; k < m_scenarios.size(); k++)
+	{
+		out << (k > 0 ? "," : "") << endl << "  ";
+		out.flush();  // or the child would write it again
+		pid_t pid = fork();
+		if (pid < 0)
+			return false;
+		if (pid == 0)
+		{
+			runScenario(m_scenarios[k], out);
+			out.flush();
+			_exit(0);
+		}
+		int status;
+		if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+			return false;
+	}
+	out << endl << "]}" << endl;
+	return true;
+}
+
+void Benchmark::runScenario(const Scenario& s, ostream& out) const
+{
+	// Game k's pit is seeded through rand(), from m_seed + k
+	ofstream devnull("/dev/null");
+	Analytics* analytics = (s.analytics ? new Analytics(s.rows, s.cols, ANALYTICSBUCKETTURNS,
+		ANALYTICSBUCKETS) : nullptr);
+
+	// Whole games through Game::takeTurn, timed as a whole
+	unsigned long long allocationsBefore = allocations.load();
+	long turns = 0;
+	long games = 0;
+	auto start = chrono::steady_clock::now();
+	while (turns < m_minTurns)
+	{
+		srand(static_cast<unsigned int>(m_seed + games));
+		Game g(s.rows, s.cols, s.nSnakes);
+		g.pit()->setResortInterval(s.resortInterval);
+		g.pit()->recordTo(analytics);
+		ScriptedPolicy policy(s.player == SCRIPTED ? SCRIPT : ".");
+		policy.start(m_seed + games);
+		int t = 0;
+		if (s.player == ADVANCING && !g.isOver())
+		{
+			t = g.pit()->advance(MAXGAMETURNS);  // and the game is over
+			turns += t;
+		}
+		for (; t < MAXGAMETURNS && !g.isOver(); t++)
+		{
+			g.takeTurn(policy.choose(*g.pit()));
+			if (s.render)
+				g.render(devnull, "");
+			turns++;
+		}
+		games++;
+	}
+	double totalNs = nsSince(start);
+	unsigned long long nAllocations = allocations.load() - allocationsBefore;
+
+	// The same games again, timing each phase of every turn.  A timed
+	// phase also counts one clock read, so take that off.
+	double clockNs = 0;
+	for (int k = 0; k < 10000; k++)
+		clockNs += nsSince(chrono::steady_clock::now());
+	clockNs /= 10000;
+	double phaseNs[NUMPHASES] = {};
+	for (long k = 0; k < games; k++)
+	{
+		srand(static_cast<unsigned int>(m_seed + k));
+		Game g(s.rows, s.cols, s.nSnakes);
+		g.pit()->setResortInterval(s.resortInterval);
+		g.pit()->recordTo(analytics);
+		ScriptedPolicy policy(s.player == SCRIPTED ? SCRIPT : ".");
+		policy.start(m_seed + k);
+		Pit* pit = g.pit();
+		Player* p = pit->player();
+		int t = 0;
+		if (s.player == ADVANCING && !g.isOver())
+		{
+			auto phaseStart = chrono::steady_clock::now();
+			t = pit->advance(MAXGAMETURNS);
+			phaseNs[SNAKES] += nsSince(phaseStart);
+		}
+		for (; t < MAXGAMETURNS && !g.isOver(); t++)
+		{
+			auto phaseStart = chrono::steady_clock::now();
+			int move = policy.choose(*pit);
+			phaseNs[CHOOSE] += nsSince(phaseStart);
+
+			phaseStart = chrono::steady_clock::now();
+			if (move == STAND)
+				p->stand();
+			else
+				p->move(move);
+			phaseNs[PLAYER] += nsSince(phaseStart);
+
+			phaseStart = chrono::steady_clock::now();
+			pit->moveSnakes();
+			phaseNs[SNAKES] += nsSince(phaseStart);
+
+			if (s.render)
+			{
+				phaseStart = chrono::steady_clock::now();
+				g.render(devnull, "");
+				phaseNs[RENDER] += nsSince(phaseStart);
+			}
+		}
+	}
+
+	delete analytics;
+
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+
+	out << fixed << setprecision(1);
+	out << "{\"rows\": " << s.rows << ", \"cols\": " << s.cols << ", \"snakes\": " << s.nSnakes
+		<< ", \"render\": " << (s.render ? "true" : "false")
+		<< ", \"resort\": " << s.resortInterval
+		<< ", \"player\": \"" << PLAYERNAMES[s.player] << "\""
+		<< ", \"analytics\": " << (s.analytics ? "true" : "false")
+		<< ", \"games\": " << games << ", \"turns\": " << turns
+		<< ", \"turnsPerSec\": " << turns / (totalNs / 1e9)
+		<< ", \"nsPerTurn\": " << totalNs / turns << ", \"nsPerPhase\": {";
+	for (int k = 0; k < NUMPHASES; k++)
+	{
+		double ns = (k != RENDER || s.render ? max(0.0, phaseNs[k] / turns - clockNs) : 0);
+		out << (k > 0 ? ", " : "") << "\"" << PHASENAMES[k] << "\": " << ns;
+	}
+	out << "}, \"peakRssKb\": " << usage.ru_maxrss;
+	if (COUNTSALLOCATIONS)
+		out << ", \"allocations\": " << nAllocations
+			<< ", \"allocationsPerTurn\": " << setprecision(3) << static_cast<double>(nAllocations) / turns;
+	else
+		out << ", \"allocations\": null, \"allocationsPerTurn\": null";
+	out << "}";
+}
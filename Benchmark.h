@@ -0,0 +1,53 @@
+#ifndef BENCHMARK_H
+
+#define BENCHMARK_H
+
+#include <iosfwd>
+#include <vector>
+
+// Whole-game throughput for a matrix of Game(rows, cols, nSnakes)
+// scenarios, for comparing builds.  Each scenario plays games from
+// fixed seeds with a scripted player until it has played at least
+// minTurns turns, optionally rendering every turn to /dev/null or
+// resorting the snakes every resortInterval turns, and then plays the
+// same games again timing each phase of a turn.  A player that only
+// stands can instead have its games played through Pit::advance,
+// whose whole run counts as the snakes' phase.  With analytics, one
+// Analytics records every game of the scenario.  It
+// runs in a child process of its own, so its peak RSS is its own.
+// The results are written as one JSON object.
+class Benchmark
+{
+public:
+	// Constructor
+	Benchmark(unsigned long long seed, long minTurns);
+
+	// How a scenario's player plays
+	enum PlayerKind { SCRIPTED, STANDING, ADVANCING };  // ADVANCING stands through Pit::advance
+
+	// Mutators
+	bool addScenario(int rows, int cols, int nSnakes, bool render, int resortInterval = 0,
+	                 PlayerKind player = SCRIPTED, bool analytics = false);
+	void addDefaultScenarios();
+	bool run(std::ostream& out);
+
+private:
+	struct Scenario
+	{
+		int  rows;
+		int  cols;
+		int  nSnakes;
+		bool render;
+		int  resortInterval;  // see Pit::setResortInterval
+		PlayerKind player;
+		bool analytics;
+	};
+
+	unsigned long long    m_seed;
+	long                  m_minTurns;
+	std::vector<Scenario> m_scenarios;
+
+	void runScenario(const Scenario& s, std::ostream& out) const;
+};
+
+#endif
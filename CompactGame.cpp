@@ -0,0 +1,333 @@
+#include "CompactGame.h"
+#include "Frame.h"
+#include "History.h"
+#include <iostream>
+#include <cstdlib>
+using namespace std;
+
+static_assert(sizeof(CompactGame) <= 256, "CompactGame must stay under 256 bytes");
+
+CompactGame::CompactGame(int rows, int cols, int nSnakes, unsigned long long seed, bool hunting)
+{
+	if (rows <= 0 || cols <= 0 || rows * cols > MAXCOMPACTCELLS)
+	{
+		cout << "***** CompactGame created with invalid size " << rows << " by "
+			<< cols << "!" << endl;
+		exit(1);
+	}
+	if (nSnakes < 0 || nSnakes > MAXCOMPACTSNAKES || (nSnakes > 0 && rows * cols == 1))
+	{
+		cout << "***** Cannot create CompactGame with " << nSnakes << " snakes!" << endl;
+		exit(1);
+	}
+	m_rows = static_cast<unsigned char>(rows);
+	m_cols = static_cast<unsigned char>(cols);
+	m_nSnakes = 0;
+	m_hunting = hunting;
+	seedRandom(seed);
+	for (int k = 0; k < MAXCOMPACTCELLS; k++)
+		m_kills[k] = 0;
+
+	// Place the player, then the snakes anywhere but on the player,
+	// drawing as startPit and Pit::spawnSnakes do
+	int rPlayer = randInt(rows);
+	int cPlayer = randInt(cols);
+	int playerCell = rPlayer * cols + cPlayer;
+	m_player = playerCell;
+	while (m_nSnakes < nSnakes)
+	{
+		int cell = randInt(rows * cols - 1);
+		if (cell >= playerCell)
+			cell++;  // skip over the player's cell
+		m_snakes[m_nSnakes] = static_cast<unsigned char>(cell);
+		m_nSnakes++;
+	}
+}
+
+int CompactGame::rows() const
+{
+	return m_rows;
+}
+
+int CompactGame::cols() const
+{
+	return m_cols;
+}
+
+int CompactGame::row() const
+{
+	return (m_player & CELLBITS) / m_cols + 1;
+}
+
+int CompactGame::col() const
+{
+	return (m_player & CELLBITS) % m_cols + 1;
+}
+
+int CompactGame::age() const
+{
+	return m_player >> AGESHIFT;
+}
+
+bool CompactGame::isDead() const
+{
+	return (m_player & DEADBIT) != 0;
+}
+
+bool CompactGame::isOver() const
+{
+	return isDead() || m_nSnakes == 0;
+}
+
+int CompactGame::snakeCount() const
+{
+	return m_nSnakes;
+}
+
+int CompactGame::cellOf(int r, int c) const
+{
+	if (r < 1 || r > m_rows || c < 1 || c > m_cols)
+		return -1;
+	return (r - 1) * m_cols + (c - 1);
+}
+
+int CompactGame::numberOfSnakesAt(int r, int c) const
+{
+	int cell = cellOf(r, c);
+	int count = 0;
+	for (int k = 0; k < m_nSnakes; k++)
+		if (m_snakes[k] == cell)
+			count++;
+	return count;
+}
+
+int CompactGame::killsAt(int r, int c) const
+{
+	int cell = cellOf(r, c);
+	if (cell < 0)
+		return 0;
+	return m_kills[cell];
+}
+
+void CompactGame::seedRandom(unsigned long long seed)
+{
+	// Same scrambling as Pit::seedRandom, so a seed gives the same game
+	seed += 0x9E3779B97F4A7C15ULL;
+	seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBULL;
+	seed ^= seed >> 31;
+	m_rng = (seed != 0 ? seed : 1);
+}
+
+int CompactGame::randInt(int limit)
+{
+	// Same generator as Pit::randInt
+	m_rng ^= m_rng >> 12;
+	m_rng ^= m_rng << 25;
+	m_rng ^= m_rng >> 27;
+	return static_cast<int>(((m_rng * 0x2545F4914F6CDD1DULL) >> 32) % limit);
+}
+
+void CompactGame::setPlayer(int cell)
+{
+	m_player = (m_player & ~CELLBITS) | cell;
+}
+
+void CompactGame::recordKill(int cell)
+{
+	// Counted in the thread's totals too, as History::record does
+	History::countInThreadTotals(cell / m_cols + 1, cell % m_cols + 1);
+	if (m_kills[cell] < MAXKILLCOUNT)
+		m_kills[cell]++;
+}
+
+void CompactGame::destroyOneSnake(int cell)
+{
+	// The snake Pit::destroyOneSnake would take: the head of the cell's
+	// list there, which is the cell's last snake in storage order, since
+	// the snakes were placed in that order when they last moved (or were
+	// spawned).  The last snake then takes its slot.
+	for (int k = m_nSnakes - 1; k >= 0; k--)
+	{
+		if (m_snakes[k] == cell)
+		{
+			m_snakes[k] = m_snakes[m_nSnakes - 1];
+			m_nSnakes--;
+			return;
+		}
+	}
+}
+
+void CompactGame::growOlder()
+{
+	// The age field is 23 bits; it sticks at its largest value rather
+	// than wrapping into nonsense
+	if (age() < MAXAGE)
+		m_player += 1 << AGESHIFT;
+}
+
+void CompactGame::stand()
+{
+	growOlder();
+}
+
+void CompactGame::move(int dir)
+{
+	// Same rules as Player::move
+	growOlder();
+	int r = row();
+	int c = col();
+	int maxCanMove = 0;  // maximum distance player can move in direction dir
+	switch (dir)
+	{
+	case UP:     maxCanMove = r - 1;      break;
+	case DOWN:   maxCanMove = m_rows - r; break;
+	case LEFT:   maxCanMove = c - 1;      break;
+	case RIGHT:  maxCanMove = m_cols - c; break;
+	}
+	if (maxCanMove == 0)  // against wall
+		return;
+	int rowDelta;
+	int colDelta;
+	if (!directionToDeltas(dir, rowDelta, colDelta))
+		return;
+
+	// No adjacent snake in direction of movement
+	if (numberOfSnakesAt(r + rowDelta, c + colDelta) == 0)
+	{
+		setPlayer(cellOf(r + rowDelta, c + colDelta));
+		return;
+	}
+
+	// Adjacent snake in direction of movement, so jump
+	if (maxCanMove >= 2)  // need a place to land
+	{
+		destroyOneSnake(cellOf(r + rowDelta, c + colDelta));
+		int landing = cellOf(r + 2 * rowDelta, c + 2 * colDelta);
+		setPlayer(landing);
+		if (numberOfSnakesAt(r + 2 * rowDelta, c + 2 * colDelta) > 0)  // landed on a snake!
+			m_player |= DEADBIT;
+		else
+			recordKill(landing);
+	}
+}
+
+bool CompactGame::moveSnakes()
+{
+	// Same rules as Snake::move and Pit::moveSnakes.  Whether the snakes
+	// hunt is settled before any of them moves, so the snakes after the
+	// one that kills the player keep hunting this turn; one already on
+	// the player's cell stays there.  With two ways closer, the draw
+	// picks the vertical step on 0, as Snake::move's list order does.
+	int playerCell = m_player & CELLBITS;
+	int pr = playerCell / m_cols;
+	int pc = playerCell % m_cols;
+	bool hunting = (m_hunting && !isDead());
+	for (int k = 0; k < m_nSnakes; k++)
+	{
+		int r = m_snakes[k] / m_cols;
+		int c = m_snakes[k] % m_cols;
+		if (hunting)
+		{
+			int rowStep = (pr > r) - (pr < r);
+			int colStep = (pc > c) - (pc < c);
+			if (rowStep != 0 && colStep != 0)
+			{
+				if (randInt(2) == 0)
+					colStep = 0;
+				else
+					rowStep = 0;
+			}
+			r += rowStep;
+			c += colStep;
+		}
+		else
+		{
+			switch (randInt(4))
+			{
+			case UP:     if (r > 0)          r--; break;
+			case DOWN:   if (r < m_rows - 1) r++; break;
+			case LEFT:   if (c > 0)          c--; break;
+			case RIGHT:  if (c < m_cols - 1) c++; break;
+			}
+		}
+		m_snakes[k] = static_cast<unsigned char>(r * m_cols + c);
+		if (m_snakes[k] == playerCell)
+			m_player |= DEADBIT;
+	}
+
+	// return true if the player is still alive, false otherwise
+	return !isDead();
+}
+
+void CompactGame::takeTurn(int dir)
+{
+	if (dir >= UP && dir <= RIGHT)
+		move(dir);
+	else
+		stand();
+	moveSnakes();
+}
+
+void CompactGame::snapshot(Frame& frame) const
+{
+	int r, c;
+	frame.rows = m_rows;
+	frame.cols = m_cols;
+	for (r = 0; r < m_rows; r++)
+		for (c = 0; c < m_cols; c++)
+			frame.grid[r][c] = '.';
+	for (int k = 0; k < m_nSnakes; k++)
+	{
+		char& gridChar = frame.grid[m_snakes[k] / m_cols][m_snakes[k] % m_cols];
+		switch (gridChar)
+		{
+		case '.':  gridChar = 'S'; break;
+		case 'S':  gridChar = '2'; break;
+		case '9':  break;
+		default:   gridChar++; break;  // '2' through '8'
+		}
+	}
+	frame.grid[row() - 1][col() - 1] = (isDead() ? '*' : '@');
+	frame.hasDanger = false;
+	frame.msg[0] = '\0';
+	frame.nSnakes = m_nSnakes;
+	frame.nPlayers = 1;
+	frame.nAlive = (isDead() ? 0 : 1);
+	frame.playerAge = age();
+	frame.playerDead = isDead();
+}
+
+void CompactGame::display() const
+{
+	Frame frame;
+	snapshot(frame);
+	clearScreen();
+	frame.draw(cout);
+}
+
+
+void CompactGame::exportObservation(unsigned char* out, int planeStride, int rowStride) const
+{
+	// As Pit::exportObservation with colStride 1 and factor 1
+	for (int r = 0; r < m_rows; r++)
+	{
+		unsigned char* snakes = out + OBS_SNAKES * planeStride + r * rowStride;
+		unsigned char* players = out + OBS_PLAYERS * planeStride + r * rowStride;
+		unsigned char* kills = out + OBS_KILLS * planeStride + r * rowStride;
+		for (int c = 0; c < m_cols; c++)
+		{
+			snakes[c] = 0;
+			players[c] = 0;
+			kills[c] = m_kills[r * m_cols + c];
+		}
+	}
+	for (int k = 0; k < m_nSnakes; k++)
+	{
+		unsigned char& n = out[OBS_SNAKES * planeStride + m_snakes[k] / m_cols * rowStride + m_snakes[k] % m_cols];
+		if (n < 255)
+			n++;
+	}
+	if (!isDead())
+		out[OBS_PLAYERS * planeStride + (row() - 1) * rowStride + (col() - 1)] = 1;
+}
\ No newline at end of file
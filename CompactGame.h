@@ -0,0 +1,73 @@
+#ifndef COMPACTGAME_H
+
+#define COMPACTGAME_H
+
+#include <iosfwd>
+#include "globals.h"
+
+struct Frame;
+
+const int MAXCOMPACTCELLS = 100;    // largest rows*cols a CompactGame can hold
+const int MAXCOMPACTSNAKES = MAXCOMPACTCELLS;  // and most snakes
+
+// A whole small game (pit, player, snakes, kill history, random number
+// generator) in under 256 bytes, played directly in that form.  Each
+// snake is a one-byte cell index, the player's cell, age and death
+// share one 32-bit word, and kills are one-byte counters saturating at
+// MAXKILLCOUNT, as History's do.  It follows Pit, Player and Snake
+// exactly: started from the same seed as startPit starts a Pit, and
+// given the same moves, it plays the same game, down to which snake a
+// jump kills.  BatchEnv runs its games this way when they fit.
+class CompactGame
+{
+public:
+	// Constructor
+	CompactGame(int rows, int cols, int nSnakes, unsigned long long seed, bool hunting = false);
+
+	// Accessors
+	int  rows() const;
+	int  cols() const;
+	int  row() const;
+	int  col() const;
+	int  age() const;
+	bool isDead() const;
+	bool isOver() const;
+	int  snakeCount() const;
+	int  numberOfSnakesAt(int r, int c) const;
+	int  killsAt(int r, int c) const;
+	void snapshot(Frame& frame) const;
+	void display() const;
+	void exportObservation(unsigned char* out, int planeStride, int rowStride) const;
+
+	// Mutators
+	void stand();
+	void move(int dir);
+	bool moveSnakes();
+	void takeTurn(int dir);  // move (or stand, if dir isn't a direction), then moveSnakes
+
+private:
+	// m_player bits
+	static const unsigned int CELLBITS = 0xFF;
+	static const unsigned int DEADBIT = 0x100;
+	static const int AGESHIFT = 9;
+	static const int MAXAGE = (1 << (32 - AGESHIFT)) - 1;  // ages saturate here
+
+	unsigned long long m_rng;  // xorshift64* state, as Pit's; nonzero
+	unsigned int  m_player;    // cell | dead << 8 | age << 9
+	unsigned char m_rows;
+	unsigned char m_cols;
+	unsigned char m_nSnakes;
+	unsigned char m_hunting;
+	unsigned char m_kills[MAXCOMPACTCELLS];    // count at each cell
+	unsigned char m_snakes[MAXCOMPACTSNAKES];  // cell of each snake, in Pit's order
+
+	int  cellOf(int r, int c) const;
+	void seedRandom(unsigned long long seed);
+	int  randInt(int limit);
+	void setPlayer(int cell);
+	void growOlder();
+	void recordKill(int cell);
+	void destroyOneSnake(int cell);
+};
+
+#endif
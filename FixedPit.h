@@ -0,0 +1,385 @@
+#ifndef FIXEDPIT_H
+
+#define FIXEDPIT_H
+
+#include <iostream>
+#include <string>
+#include "globals.h"
+#include "Frame.h"
+
+// A pit whose size and snake capacity are compile-time constants, for
+// the sizes that are played most (see PitFactory.h).  It follows the
+// same rules as Pit, Player and Snake, and offers the same interface
+// (player()->move(dir), moveSnakes(), snapshot(), ...) so code written
+// as a template works on either; but with the bounds known, the wall
+// checks and display loops compile to fixed-trip, mostly branch-free
+// code.  It has one player.
+template <int Rows, int Cols, int MaxSnakes>
+class FixedPit
+{
+public:
+	static_assert(Rows > 0 && Cols > 0 && Rows <= MAXROWS && Cols <= MAXCOLS, "bad pit size");
+	static_assert(Cols <= 64, "a pit row must fit in one bitboard word");
+	static_assert(MaxSnakes > 0 && MaxSnakes <= MAXSNAKES, "bad snake capacity");
+
+	class FixedPlayer
+	{
+	public:
+		// Accessors
+		int  row() const    { return m_row; }
+		int  col() const    { return m_col; }
+		int  age() const    { return m_age; }
+		bool isDead() const { return m_dead; }
+
+		// Mutators
+		void stand()   { m_age++; }
+		void setDead() { m_dead = true; }
+		void move(int dir);
+
+	private:
+		friend class FixedPit;
+		FixedPit* m_pit;
+		int  m_row;
+		int  m_col;
+		int  m_age;
+		bool m_dead;
+	};
+
+	// Constructor
+	FixedPit();
+
+	// Accessors
+	static constexpr int rows() { return Rows; }
+	static constexpr int cols() { return Cols; }
+	FixedPlayer* player()       { return m_hasPlayer ? &m_player : nullptr; }
+	int  snakeCount() const     { return m_nSnakes; }
+	bool isHunting() const      { return m_hunting; }
+	int  numberOfSnakesAt(int r, int c) const;
+	bool hasSnakeAt(int r, int c) const;
+	void snapshot(Frame& frame, std::string msg) const;
+	void display(std::string msg) const;
+
+	// Mutators
+	bool addSnake(int r, int c);
+	bool spawnSnakes(int n, int rExcluded = 0, int cExcluded = 0);
+	bool addPlayer(int r, int c);
+	bool destroyOneSnake(int r, int c);
+	bool moveSnakes();
+	void setHunting(bool hunting) { m_hunting = hunting; }
+	void seedRandom(unsigned long long seed);
+	int  randInt(int limit);
+
+private:
+	unsigned char m_snakeRow[MaxSnakes];  // 0-based
+	unsigned char m_snakeCol[MaxSnakes];
+	unsigned char m_occupancy[Rows][Cols];
+	unsigned long long m_snakeBits[Rows];  // bit c of [r] set if m_occupancy[r][c] > 0
+	short m_firstAtCell[Rows][Cols];  // cell lists of snake indices, as in Pit
+	short m_nextAtCell[MaxSnakes];
+	short m_prevAtCell[MaxSnakes];
+	int  m_nSnakes;
+	bool m_hunting;
+	bool m_hasPlayer;
+	FixedPlayer m_player;
+	unsigned long long m_rng;
+
+	void link(int k, int r, int c);
+	void unlink(int k, int r, int c);
+};
+
+///////////////////////////////////////////////////////////////////////////
+//  FixedPit implementation
+///////////////////////////////////////////////////////////////////////////
+
+template <int Rows, int Cols, int MaxSnakes>
+FixedPit<Rows, Cols, MaxSnakes>::FixedPit()
+{
+	m_nSnakes = 0;
+	m_hunting = false;
+	m_hasPlayer = false;
+	m_player.m_pit = this;
+	m_player.m_row = 1;
+	m_player.m_col = 1;
+	m_player.m_age = 0;
+	m_player.m_dead = false;
+	for (int r = 0; r < Rows; r++)
+	{
+		for (int c = 0; c < Cols; c++)
+		{
+			m_occupancy[r][c] = 0;
+			m_firstAtCell[r][c] = -1;
+		}
+		m_snakeBits[r] = 0;
+	}
+	seedRandom(1);
+}
+
+template <int Rows, int Cols, int MaxSnakes>
+int FixedPit<Rows, Cols, MaxSnakes>::numberOfSnakesAt(int r, int c) const
+{
+	// One unsigned compare per coordinate covers both walls
+	if (static_cast<unsigned int>(r - 1) >= static_cast<unsigned int>(Rows) ||
+		static_cast<unsigned int>(c - 1) >= static_cast<unsigned int>(Cols))
+		return 0;
+	return m_occupancy[r - 1][c - 1];
+}
+
+template <int Rows, int Cols, int MaxSnakes>
+bool FixedPit<Rows, Cols, MaxSnakes>::hasSnakeAt(int r, int c) const
+{
+	if (static_cast<unsigned int>(r - 1) >= static_cast<unsigned int>(Rows) ||
+		static_cast<unsigned int>(c - 1) >= static_cast<unsigned int>(Cols))
+		return false;
+	return (m_snakeBits[r - 1] >> (c - 1)) & 1;
+}
+
+template <int Rows, int Cols, int MaxSnakes>
+bool FixedPit<Rows, Cols, MaxSnakes>::addSnake(int r, int c)
+{
+	if (m_nSnakes == MaxSnakes || r < 1 || r > Rows || c < 1 || c > Cols)
+		return false;
+	m_snakeRow[m_nSnakes] = static_cast<unsigned char>(r - 1);
+	m_snakeCol[m_nSnakes] = static_cast<unsigned char>(c - 1);
+	m_nSnakes++;
+	link(m_nSnakes - 1, r - 1, c - 1);
+	return true;
+}
+
+template <int Rows, int Cols, int MaxSnakes>
+bool FixedPit<Rows, Cols, MaxSnakes>::spawnSnakes(int n, int rExcluded, int cExcluded)
+{
+	// Same draws as Pit::spawnSnakes
+	int cells = Rows * Cols;
+	int excluded = -1;
+	if (rExcluded >= 1 && rExcluded <= Rows && cExcluded >= 1 && cExcluded <= Cols)
+	{
+		excluded = (rExcluded - 1) * Cols + (cExcluded - 1);
+		cells--;
+	}
+	if (n < 0 || m_nSnakes + n > MaxSnakes || (n > 0 && cells == 0))
+		return false;
+	for (int k = 0; k < n; k++)
+	{
+		int cell = randInt(cells);
+		if (excluded >= 0 && cell >= excluded)
+			cell++;
+		addSnake(1 + cell / Cols, 1 + cell % Cols);
+	}
+	return true;
+}
+
+template <int Rows, int Cols, int MaxSnakes>
+bool FixedPit<Rows, Cols, MaxSnakes>::addPlayer(int r, int c)
+{
+	if (m_hasPlayer || r < 1 || r > Rows || c < 1 || c > Cols)
+		return false;
+	m_player.m_row = r;
+	m_player.m_col = c;
+	m_player.m_age = 0;
+	m_player.m_dead = false;
+	m_hasPlayer = true;
+	return true;
+}
+
+template <int Rows, int Cols, int MaxSnakes>
+bool FixedPit<Rows, Cols, MaxSnakes>::destroyOneSnake(int r, int c)
+{
+	// Kill the same snake Pit::destroyOneSnake would, so a seed plays
+	// the same game on either
+	if (r < 1 || r > Rows || c < 1 || c > Cols || m_firstAtCell[r - 1][c - 1] < 0)
+		return false;
+	int k = m_firstAtCell[r - 1][c - 1];
+	unlink(k, r - 1, c - 1);
+	int last = m_nSnakes - 1;
+	if (k != last)
+	{
+		int lastRow = m_snakeRow[last];
+		int lastCol = m_snakeCol[last];
+		m_snakeRow[k] = m_snakeRow[last];
+		m_snakeCol[k] = m_snakeCol[last];
+		int next = m_nextAtCell[last];
+		int prev = m_prevAtCell[last];
+		m_nextAtCell[k] = static_cast<short>(next);
+		m_prevAtCell[k] = static_cast<short>(prev);
+		if (next >= 0)
+			m_prevAtCell[next] = static_cast<short>(k);
+		if (prev >= 0)
+			m_nextAtCell[prev] = static_cast<short>(k);
+		else
+			m_firstAtCell[lastRow][lastCol] = static_cast<short>(k);
+	}
+	m_nSnakes--;
+	return true;
+}
+
+template <int Rows, int Cols, int MaxSnakes>
+void FixedPit<Rows, Cols, MaxSnakes>::link(int k, int r, int c)
+{
+	// Same bookkeeping as Pit::placeSnake, with 0-based r and c
+	m_occupancy[r][c]++;
+	m_snakeBits[r] |= 1ULL << c;
+	int first = m_firstAtCell[r][c];
+	m_nextAtCell[k] = static_cast<short>(first);
+	m_prevAtCell[k] = -1;
+	if (first >= 0)
+		m_prevAtCell[first] = static_cast<short>(k);
+	m_firstAtCell[r][c] = static_cast<short>(k);
+}
+
+template <int Rows, int Cols, int MaxSnakes>
+void FixedPit<Rows, Cols, MaxSnakes>::unlink(int k, int r, int c)
+{
+	if (--m_occupancy[r][c] == 0)
+		m_snakeBits[r] &= ~(1ULL << c);
+	int next = m_nextAtCell[k];
+	int prev = m_prevAtCell[k];
+	if (next >= 0)
+		m_prevAtCell[next] = static_cast<short>(prev);
+	if (prev >= 0)
+		m_nextAtCell[prev] = static_cast<short>(next);
+	else
+		m_firstAtCell[r][c] = static_cast<short>(next);
+}
+
+template <int Rows, int Cols, int MaxSnakes>
+bool FixedPit<Rows, Cols, MaxSnakes>::moveSnakes()
+{
+	int pr = m_player.m_row - 1;
+	int pc = m_player.m_col - 1;
+	bool hunt = m_hunting && m_hasPlayer && !m_player.m_dead;
+	for (int k = 0; k < m_nSnakes; k++)
+	{
+		int r = m_snakeRow[k];
+		int c = m_snakeCol[k];
+		unlink(k, r, c);
+		if (hunt && (r != pr || c != pc))
+		{
+			int rowStep = (pr > r) - (pr < r);
+			int colStep = (pc > c) - (pc < c);
+			if (rowStep != 0 && colStep != 0)
+			{
+				// Snake::move lists the vertical step first
+				if (randInt(2) == 0)
+					colStep = 0;
+				else
+					rowStep = 0;
+			}
+			r += rowStep;
+			c += colStep;
+		}
+		else
+		{
+			// Same as Snake::move: a direction into a wall means no move
+			int dir = randInt(4);
+			r += (dir == DOWN && r < Rows - 1) - (dir == UP && r > 0);
+			c += (dir == RIGHT && c < Cols - 1) - (dir == LEFT && c > 0);
+		}
+		m_snakeRow[k] = static_cast<unsigned char>(r);
+		m_snakeCol[k] = static_cast<unsigned char>(c);
+		link(k, r, c);
+	}
+
+	if (!m_hasPlayer)
+		return false;
+
+	// Only one cell can hold the player, so the collision test is a
+	// single bit of the bitboard rather than a compare per snake
+	if ((m_snakeBits[pr] >> pc) & 1)
+		m_player.m_dead = true;
+
+	// return true if the player is still alive, false otherwise
+	return !m_player.m_dead;
+}
+
+template <int Rows, int Cols, int MaxSnakes>
+void FixedPit<Rows, Cols, MaxSnakes>::FixedPlayer::move(int dir)
+{
+	// Same rules as Player::move
+	m_age++;
+	int maxCanMove = 0;  // maximum distance player can move in direction dir
+	switch (dir)
+	{
+	case UP:     maxCanMove = m_row - 1;    break;
+	case DOWN:   maxCanMove = Rows - m_row; break;
+	case LEFT:   maxCanMove = m_col - 1;    break;
+	case RIGHT:  maxCanMove = Cols - m_col; break;
+	}
+	if (maxCanMove == 0)  // against wall
+		return;
+	int rowDelta;
+	int colDelta;
+	if (!directionToDeltas(dir, rowDelta, colDelta))
+		return;
+
+	// No adjacent snake in direction of movement
+	if (!m_pit->hasSnakeAt(m_row + rowDelta, m_col + colDelta))
+	{
+		m_row += rowDelta;
+		m_col += colDelta;
+		return;
+	}
+
+	// Adjacent snake in direction of movement, so jump
+	if (maxCanMove >= 2)  // need a place to land
+	{
+		m_pit->destroyOneSnake(m_row + rowDelta, m_col + colDelta);
+		m_row += 2 * rowDelta;
+		m_col += 2 * colDelta;
+		if (m_pit->hasSnakeAt(m_row, m_col))  // landed on a snake!
+			setDead();
+	}
+}
+
+template <int Rows, int Cols, int MaxSnakes>
+void FixedPit<Rows, Cols, MaxSnakes>::seedRandom(unsigned long long seed)
+{
+	// Same generator and seeding as Pit, so a seed plays the same game
+	seed += 0x9E3779B97F4A7C15ULL;
+	seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBULL;
+	seed ^= seed >> 31;
+	m_rng = (seed != 0 ? seed : 1);
+}
+
+template <int Rows, int Cols, int MaxSnakes>
+int FixedPit<Rows, Cols, MaxSnakes>::randInt(int limit)
+{
+	m_rng ^= m_rng >> 12;
+	m_rng ^= m_rng << 25;
+	m_rng ^= m_rng >> 27;
+	return static_cast<int>(((m_rng * 0x2545F4914F6CDD1DULL) >> 32) % limit);
+}
+
+template <int Rows, int Cols, int MaxSnakes>
+void FixedPit<Rows, Cols, MaxSnakes>::snapshot(Frame& frame, std::string msg) const
+{
+	frame.rows = Rows;
+	frame.cols = Cols;
+	for (int r = 0; r < Rows; r++)
+		for (int c = 0; c < Cols; c++)
+		{
+			int n = m_occupancy[r][c];
+			frame.grid[r][c] = (n == 0 ? '.' : n == 1 ? 'S' : n < 9 ? static_cast<char>('0' + n) : '9');
+		}
+	if (m_hasPlayer)
+		frame.grid[m_player.m_row - 1][m_player.m_col - 1] = (m_player.m_dead ? '*' : '@');
+	frame.hasDanger = false;
+	size_t len = msg.copy(frame.msg, MAXMSG);
+	frame.msg[len] = '\0';
+	frame.nSnakes = m_nSnakes;
+	frame.nPlayers = (m_hasPlayer ? 1 : 0);
+	frame.nAlive = (m_hasPlayer && !m_player.m_dead ? 1 : 0);
+	frame.playerAge = (m_hasPlayer ? m_player.m_age : 0);
+	frame.playerDead = m_hasPlayer && m_player.m_dead;
+}
+
+template <int Rows, int Cols, int MaxSnakes>
+void FixedPit<Rows, Cols, MaxSnakes>::display(std::string msg) const
+{
+	Frame frame;
+	snapshot(frame, msg);
+	clearScreen();
+	frame.draw(std::cout);
+}
+
+#endif
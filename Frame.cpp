@@ -0,0 +1,47 @@
+#include "Frame.h"
+#include <iostream>
+using namespace std;
+
+void Frame::draw(ostream& out) const
+{
+	int r, c;
+
+	// Draw the grid
+	for (r = 0; r < rows; r++)
+	{
+		for (c = 0; c < cols; c++)
+			out << grid[r][c];
+		out << endl;
+	}
+	out << endl;
+
+	// Overlay the chance (in tenths) of a snake being in each cell next turn
+	if (hasDanger)
+	{
+		out << "Chance of a snake next turn (tenths, ! = certain):" << endl;
+		for (r = 0; r < rows; r++)
+		{
+			for (c = 0; c < cols; c++)
+				out << danger[r][c];
+			out << endl;
+		}
+		out << endl;
+	}
+
+	// Write message, snake, and player info
+	out << endl;
+	if (msg[0] != '\0')
+		out << msg << endl;
+	out << "There are " << nSnakes << " snakes remaining." << endl;
+	if (nPlayers == 0)
+		out << "There is no player." << endl;
+	else if (nPlayers == 1)
+	{
+		if (playerAge > 0)
+			out << "The player has lasted " << playerAge << " steps." << endl;
+		if (playerDead)
+			out << "The player is dead." << endl;
+	}
+	else
+		out << nAlive << " of " << nPlayers << " players are alive." << endl;
+}
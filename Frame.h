@@ -0,0 +1,30 @@
+#ifndef FRAME_H
+
+#define FRAME_H
+
+#include <iosfwd>
+#include "globals.h"
+
+const int MAXMSG = 80;              // longest message a frame keeps
+
+// Everything Pit::display shows for one turn, captured by Pit::snapshot.
+// It holds no pointers, so frames can be copied between threads and
+// drawn long after the pit has moved on.
+struct Frame
+{
+	int  rows;
+	int  cols;
+	char grid[MAXROWS][MAXCOLS];
+	bool hasDanger;
+	char danger[MAXROWS][MAXCOLS];  // '.', '0'-'9' tenths, '!' certain
+	char msg[MAXMSG + 1];
+	int  nSnakes;
+	int  nPlayers;
+	int  nAlive;
+	int  playerAge;  // of the first player
+	bool playerDead;
+
+	void draw(std::ostream& out) const;
+};
+
+#endif
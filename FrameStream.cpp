@@ -0,0 +1,528 @@
+#include "FrameStream.h"
+#include <cstring>
+#include <cstdint>
+#include <chrono>
+#include <bit>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+using namespace std;
+
+// findChanges reads eight cells as one word, first cell lowest
+static_assert(endian::native == endian::little, "frame streams assume a little-endian host");
+
+namespace
+{
+	const char MAGIC[8] = { 'S', 'N', 'A', 'K', 'E', 'F', 'R', 'M' };
+	const uint32_t VERSION = 1;
+	const size_t FILEHEADER = sizeof(MAGIC) + 4;
+
+	enum { KEYFRAME = 0, DELTAFRAME = 1 };
+	enum { HASDANGER = 1, PLAYERDEAD = 2 };
+
+	const size_t BATCH = 64;  // frames the writer waits for before waking
+	const chrono::milliseconds MAXDELAY(100);  // ... unless they're this old
+
+	void put32(vector<unsigned char>& out, uint32_t v)
+	{
+		for (int k = 0; k < 4; k++)
+			out.push_back(static_cast<unsigned char>(v >> (8 * k)));
+	}
+
+	// Copies the first rows x cols of a plane into cells, row by row
+	void flatten(char* cells, const char plane[MAXROWS][MAXCOLS], int rows, int cols)
+	{
+		for (int r = 0; r < rows; r++)
+			memcpy(cells + r * cols, plane[r], cols);
+	}
+
+	unsigned char* putVarint(unsigned char* p, size_t v)
+	{
+		while (v >= 0x80)
+		{
+			*p++ = static_cast<unsigned char>(v | 0x80);
+			v >>= 7;
+		}
+		*p++ = static_cast<unsigned char>(v);
+		return p;
+	}
+
+	// Sets bit k of changed[k / 64] for each cell k that differs from
+	// base, comparing eight cells per step
+	void findChanges(uint64_t changed[], const char* cells, const char* base, size_t n)
+	{
+		const uint64_t low7 = 0x7f7f7f7f7f7f7f7fULL;
+		for (size_t w = 0; w * 64 < n; w++)
+			changed[w] = 0;
+		size_t k = 0;
+		for (; k + 8 <= n; k += 8)
+		{
+			uint64_t a, b;
+			memcpy(&a, cells + k, 8);
+			memcpy(&b, base + k, 8);
+			uint64_t x = a ^ b;
+			// High bit of each byte set if that byte of x is nonzero,
+			// then those eight bits gathered into the low byte
+			uint64_t high = (((x & low7) + low7) | x) & ~low7;
+			uint64_t bits = (high >> 7) * 0x0102040810204080ULL >> 56;
+			changed[k / 64] |= bits << (k % 64);
+		}
+		for (; k < n; k++)
+			if (cells[k] != base[k])
+				changed[k / 64] |= 1ULL << (k % 64);
+	}
+
+	// Codes cells against base (each n long) as a bitmask of the cells
+	// that changed followed by their new characters, in order.  The mask
+	// is run-length coded: alternating runs of zero and nonzero bytes,
+	// each run's length a varint and only the nonzero bytes stored.
+	void codeCells(vector<unsigned char>& out, const char* cells, const char* base, size_t n)
+	{
+		uint64_t changed[(MAXROWS * MAXCOLS + 63) / 64];
+		findChanges(changed, cells, base, n);
+		size_t nWords = (n + 63) / 64;
+		size_t nBytes = (n + 7) / 8;
+		auto maskByte = [&changed](size_t j) {
+			return static_cast<unsigned char>(changed[j / 8] >> (8 * (j % 8)));
+		};
+
+		// Write straight into room for the worst case: every other mask
+		// byte nonzero, and every cell changed
+		size_t used = out.size();
+		out.resize(used + 3 * nBytes + n + 2);
+		unsigned char* p = out.data() + used;
+		size_t j = 0;
+		while (j < nBytes)
+		{
+			size_t start = j;
+			while (j < nBytes && maskByte(j) == 0)
+				j++;
+			p = putVarint(p, j - start);
+			start = j;
+			while (j < nBytes && maskByte(j) != 0)
+				j++;
+			p = putVarint(p, j - start);
+			for (size_t k = start; k < j; k++)
+				*p++ = maskByte(k);
+		}
+		for (size_t w = 0; w < nWords; w++)
+			for (uint64_t bits = changed[w]; bits != 0; bits &= bits - 1)
+				*p++ = static_cast<unsigned char>(cells[64 * w + countr_zero(bits)]);
+		out.resize(p - out.data());
+	}
+
+	void fillPlane(char plane[MAXROWS][MAXCOLS])
+	{
+		memset(plane, '.', MAXROWS * MAXCOLS);
+	}
+
+	bool writeAll(int fd, const unsigned char* p, size_t n)
+	{
+		while (n > 0)
+		{
+			ssize_t written = ::write(fd, p, n);
+			if (written <= 0)
+				return false;
+			p += written;
+			n -= written;
+		}
+		return true;
+	}
+
+	// Reads a record's fields; every get fails once the record runs out
+	class Cursor
+	{
+	public:
+		Cursor(const unsigned char* p, size_t n) : m_p(p), m_end(p + n) {}
+
+		bool atEnd() const { return m_p == m_end; }
+
+		bool getByte(unsigned char& v)
+		{
+			if (m_p == m_end)
+				return false;
+			v = *m_p++;
+			return true;
+		}
+
+		bool get32(uint32_t& v)
+		{
+			if (m_end - m_p < 4)
+				return false;
+			v = 0;
+			for (int k = 0; k < 4; k++)
+				v |= static_cast<uint32_t>(*m_p++) << (8 * k);
+			return true;
+		}
+
+		bool getVarint(size_t& v)
+		{
+			v = 0;
+			for (int shift = 0; shift < 28; shift += 7)
+			{
+				unsigned char b;
+				if (!getByte(b))
+					return false;
+				v |= static_cast<size_t>(b & 0x7f) << shift;
+				if ((b & 0x80) == 0)
+					return true;
+			}
+			return false;
+		}
+
+		bool getBytes(char* dest, size_t n)
+		{
+			if (static_cast<size_t>(m_end - m_p) < n)
+				return false;
+			memcpy(dest, m_p, n);
+			m_p += n;
+			return true;
+		}
+
+		bool decodePlane(char plane[MAXROWS][MAXCOLS], int rows, int cols)
+		{
+			// plane holds the base on entry; see codeCells
+			size_t n = rows * cols;
+			size_t nBytes = (n + 7) / 8;
+			unsigned char mask[(MAXROWS * MAXCOLS + 7) / 8] = {};
+			size_t j = 0;
+			while (j < nBytes)
+			{
+				size_t zeros, nonzeros;
+				if (!getVarint(zeros) || zeros > nBytes - j)
+					return false;
+				j += zeros;
+				if (!getVarint(nonzeros) || nonzeros > nBytes - j ||
+						!getBytes(reinterpret_cast<char*>(mask + j), nonzeros))
+					return false;
+				j += nonzeros;
+			}
+			if (n % 8 != 0 && (mask[nBytes - 1] >> (n % 8)) != 0)
+				return false;
+			for (j = 0; j < nBytes; j++)
+			{
+				for (unsigned bits = mask[j]; bits != 0; bits &= bits - 1)
+				{
+					size_t k = 8 * j + countr_zero(bits);
+					unsigned char v;
+					if (!getByte(v))
+						return false;
+					plane[k / cols][k % cols] = static_cast<char>(v);
+				}
+			}
+			return true;
+		}
+
+	private:
+		const unsigned char* m_p;
+		const unsigned char* m_end;
+	};
+}
+
+//*********************************************************************
+//  FrameWriter
+//*********************************************************************
+
+FrameWriter::FrameWriter(const string& path)
+{
+	m_nFrames = 0;
+	m_stopping = false;
+	m_failed = false;
+	m_fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (m_fd < 0)
+		return;
+	vector<unsigned char> header(MAGIC, MAGIC + sizeof(MAGIC));
+	put32(header, VERSION);
+	if (!writeAll(m_fd, header.data(), header.size()))
+	{
+		::close(m_fd);
+		m_fd = -1;
+		return;
+	}
+	m_queued.reserve(BATCH);
+	m_thread = thread(&FrameWriter::run, this);
+}
+
+FrameWriter::~FrameWriter()
+{
+	close();
+}
+
+bool FrameWriter::isOpen() const
+{
+	return m_fd >= 0;
+}
+
+bool FrameWriter::failed() const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_failed;
+}
+
+long FrameWriter::framesWritten() const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_nFrames;
+}
+
+void FrameWriter::write(const Frame& frame)
+{
+	// Only waits if the writer has fallen MAXQUEUED frames behind; does
+	// nothing once recording has failed
+	if (m_fd < 0)
+		return;
+	unique_lock<mutex> lock(m_mutex);
+	m_room.wait(lock, [this] { return m_failed || m_queued.size() < MAXQUEUED; });
+	if (m_failed)
+		return;
+	m_queued.push_back(frame);
+	if (m_queued.size() == BATCH)
+		m_wake.notify_one();
+}
+
+void FrameWriter::close()
+{
+	// Writes what is queued and closes the file; later frames are dropped
+	if (m_fd < 0)
+		return;
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_wake.notify_one();
+	m_thread.join();
+	::close(m_fd);
+	m_fd = -1;
+}
+
+void FrameWriter::run()
+{
+	// The planes last coded against, flattened; a fresh writer starts
+	// with a key frame
+	const size_t maxCells = MAXROWS * MAXCOLS;
+	char grid[maxCells];
+	char danger[maxCells];
+	char cells[maxCells];
+	int rows = 0;
+	int cols = 0;
+	bool hadDanger = false;
+	int sinceKey = KEYINTERVAL;
+
+	vector<Frame> batch;
+	batch.reserve(BATCH);
+	vector<unsigned char> out;
+	for (;;)
+	{
+		bool stopping;
+		{
+			unique_lock<mutex> lock(m_mutex);
+			m_wake.wait_for(lock, MAXDELAY,
+				[this] { return m_stopping || m_queued.size() >= BATCH; });
+			batch.swap(m_queued);
+			stopping = m_stopping;
+		}
+		m_room.notify_all();
+
+		out.clear();
+		for (const Frame& f : batch)
+		{
+			size_t start = out.size();
+			put32(out, 0);  // the record's length, filled in below
+			bool key = (sinceKey >= KEYINTERVAL || f.rows != rows || f.cols != cols);
+			if (key)
+			{
+				memset(grid, '.', maxCells);
+				sinceKey = 0;
+			}
+			if (key || !hadDanger)
+				memset(danger, '.', maxCells);
+			sinceKey++;
+			out.push_back(key ? KEYFRAME : DELTAFRAME);
+			out.push_back(static_cast<unsigned char>(f.rows));
+			out.push_back(static_cast<unsigned char>(f.cols));
+			out.push_back((f.hasDanger ? HASDANGER : 0) | (f.playerDead ? PLAYERDEAD : 0));
+			put32(out, f.nSnakes);
+			put32(out, f.nPlayers);
+			put32(out, f.nAlive);
+			put32(out, f.playerAge);
+			size_t msgLen = strnlen(f.msg, MAXMSG);
+			out.push_back(static_cast<unsigned char>(msgLen));
+			out.insert(out.end(), f.msg, f.msg + msgLen);
+			size_t n = f.rows * f.cols;
+			flatten(cells, f.grid, f.rows, f.cols);
+			codeCells(out, cells, grid, n);
+			memcpy(grid, cells, n);
+			if (f.hasDanger)
+			{
+				flatten(cells, f.danger, f.rows, f.cols);
+				codeCells(out, cells, danger, n);
+				memcpy(danger, cells, n);
+			}
+
+			uint32_t length = static_cast<uint32_t>(out.size() - start - 4);
+			for (int k = 0; k < 4; k++)
+				out[start + k] = static_cast<unsigned char>(length >> (8 * k));
+			rows = f.rows;
+			cols = f.cols;
+			hadDanger = f.hasDanger;
+		}
+		if (!out.empty() && !writeAll(m_fd, out.data(), out.size()))
+		{
+			// Stop: frames after this would be coded against ones the
+			// file doesn't have.  FrameReader leaves out the torn record
+			// this write may have ended on.
+			{
+				lock_guard<mutex> lock(m_mutex);
+				m_failed = true;
+				m_queued.clear();
+			}
+			m_room.notify_all();
+			break;
+		}
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_nFrames += batch.size();
+		}
+		batch.clear();
+		if (stopping)
+			break;
+	}
+}
+
+//*********************************************************************
+//  FrameReader
+//*********************************************************************
+
+FrameReader::FrameReader(const string& path)
+{
+	m_data = nullptr;
+	m_size = 0;
+	m_currentIndex = -1;
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < FILEHEADER)
+	{
+		close(fd);
+		return;
+	}
+	size_t size = st.st_size;
+	void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mapped == MAP_FAILED)
+		return;
+	const unsigned char* base = static_cast<const unsigned char*>(mapped);
+	Cursor header(base + sizeof(MAGIC), 4);
+	uint32_t version;
+	if (memcmp(base, MAGIC, sizeof(MAGIC)) != 0 || !header.get32(version) || version != VERSION)
+	{
+		munmap(mapped, size);
+		return;
+	}
+	m_data = base;
+	m_size = size;
+
+	// Index the records; a torn last record (from a writer that didn't
+	// get to finish) is left out
+	size_t pos = FILEHEADER;
+	int lastKey = -1;
+	while (size - pos >= 5)
+	{
+		Cursor length(m_data + pos, 4);
+		uint32_t n;
+		length.get32(n);
+		if (n == 0 || n > size - pos - 4)
+			break;
+		if (m_data[pos + 4] == KEYFRAME)
+			lastKey = static_cast<int>(m_offsets.size());
+		else if (lastKey < 0)
+			break;
+		m_offsets.push_back(pos + 4);
+		m_lastKey.push_back(lastKey);
+		pos += 4 + n;
+	}
+}
+
+FrameReader::~FrameReader()
+{
+	if (m_data != nullptr)
+		munmap(const_cast<unsigned char*>(m_data), m_size);
+}
+
+bool FrameReader::isOpen() const
+{
+	return m_data != nullptr;
+}
+
+int FrameReader::frameCount() const
+{
+	return static_cast<int>(m_offsets.size());
+}
+
+bool FrameReader::read(int n, Frame& frame)
+{
+	// Go forward from the frame last read if it's past n's key frame;
+	// otherwise start over from that key frame
+	if (n < 0 || n >= frameCount())
+		return false;
+	int from = m_lastKey[n];
+	if (m_currentIndex >= from && m_currentIndex <= n)
+		from = m_currentIndex + 1;
+	for (int k = from; k <= n; k++)
+	{
+		if (!decode(k))
+		{
+			m_currentIndex = -1;
+			return false;
+		}
+	}
+	m_currentIndex = n;
+	frame = m_current;
+	return true;
+}
+
+bool FrameReader::decode(int n)
+{
+	// Applies record n to m_current, which must hold frame n-1 unless
+	// record n is a key frame
+	size_t start = m_offsets[n];
+	uint32_t length;
+	Cursor(m_data + start - 4, 4).get32(length);  // checked when indexed
+	Cursor in(m_data + start, length);
+	unsigned char kind, rows, cols, flags, msgLen;
+	uint32_t nSnakes, nPlayers, nAlive, playerAge;
+	if (!in.getByte(kind) || !in.getByte(rows) || !in.getByte(cols) || !in.getByte(flags) ||
+			!in.get32(nSnakes) || !in.get32(nPlayers) || !in.get32(nAlive) ||
+			!in.get32(playerAge) || !in.getByte(msgLen))
+		return false;
+	if (rows < 1 || rows > MAXROWS || cols < 1 || cols > MAXCOLS || msgLen > MAXMSG)
+		return false;
+	Frame& f = m_current;
+	if (kind == KEYFRAME)
+	{
+		fillPlane(f.grid);
+		fillPlane(f.danger);
+	}
+	else if (f.rows != rows || f.cols != cols)
+		return false;
+	else if (!f.hasDanger)
+		fillPlane(f.danger);
+	f.rows = rows;
+	f.cols = cols;
+	f.hasDanger = (flags & HASDANGER) != 0;
+	f.playerDead = (flags & PLAYERDEAD) != 0;
+	f.nSnakes = static_cast<int32_t>(nSnakes);
+	f.nPlayers = static_cast<int32_t>(nPlayers);
+	f.nAlive = static_cast<int32_t>(nAlive);
+	f.playerAge = static_cast<int32_t>(playerAge);
+	if (!in.getBytes(f.msg, msgLen))
+		return false;
+	f.msg[msgLen] = '\0';
+	if (!in.decodePlane(f.grid, rows, cols))
+		return false;
+	if (f.hasDanger && !in.decodePlane(f.danger, rows, cols))
+		return false;
+	return in.atEnd();
+}
@@ -0,0 +1,95 @@
+#ifndef FRAMESTREAM_H
+
+#define FRAMESTREAM_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "Frame.h"
+
+// A frame stream file is the magic "SNAKEFRM", a 4-byte version, and
+// then one record per frame: a 4-byte length followed by that many
+// bytes.  A record holds the frame's counts and message, then its grid
+// (and danger map, if shown) coded against the previous frame's: a
+// bitmask of the cells that changed, run-length coded, followed by just
+// those cells' characters.  A key frame is coded against an empty ('.')
+// grid instead, so it can be decoded on its own; there is one every
+// KEYINTERVAL frames, and whenever the pit's size changes.  All
+// integers are little-endian.
+const int KEYINTERVAL = 100;
+
+// Records frames to a file.  write() only queues a copy of the frame;
+// a background thread codes the queued frames and writes them out in
+// batches.  close() (or the destructor) writes whatever is still
+// queued.  If a batch can't be written, recording stops there (later
+// frames would be coded against ones the file doesn't have) and
+// failed() reports it; the file keeps every whole frame before that.
+class FrameWriter
+{
+public:
+	// Constructor/destructor
+	FrameWriter(const std::string& path);
+	~FrameWriter();
+
+	// Accessors
+	bool isOpen() const;
+	bool failed() const;
+	long framesWritten() const;
+
+	// Mutators
+	void write(const Frame& frame);
+	void close();
+
+private:
+	static const size_t MAXQUEUED = 1024;  // write() waits beyond this
+
+	int                m_fd;
+	std::vector<Frame> m_queued;   // guarded by m_mutex
+	long               m_nFrames;  // guarded by m_mutex
+	bool               m_stopping;
+	bool               m_failed;   // guarded by m_mutex
+	mutable std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_room;
+	std::thread        m_thread;
+
+	void run();
+
+	FrameWriter(const FrameWriter&) = delete;
+	FrameWriter& operator=(const FrameWriter&) = delete;
+};
+
+// Reads a frame stream written by FrameWriter, in any order: going to
+// a frame decodes forward from the key frame before it (or from the
+// frame last read, if that is closer).
+class FrameReader
+{
+public:
+	// Constructor/destructor
+	FrameReader(const std::string& path);
+	~FrameReader();
+
+	// Accessors
+	bool isOpen() const;
+	int  frameCount() const;
+
+	// Mutators
+	bool read(int n, Frame& frame);
+
+private:
+	const unsigned char* m_data;  // the mapped file
+	size_t               m_size;
+	std::vector<size_t>  m_offsets;  // of each record's contents
+	std::vector<int>     m_lastKey;  // key frame at or before each frame
+	Frame                m_current;
+	int                  m_currentIndex;  // frame in m_current, or -1
+
+	bool decode(int n);
+
+	FrameReader(const FrameReader&) = delete;
+	FrameReader& operator=(const FrameReader&) = delete;
+};
+
+#endif
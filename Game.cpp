@@ -1,100 +1,253 @@
-#include "Game.h"
-#include "globals.h"
-#include "Player.h"
-#include "Pit.h"
-#include <iostream>
-#include <cstdlib>
-using namespace std;
-
-Game::Game(int rows, int cols, int nSnakes)
-{
-	if (nSnakes < 0)
-	{
-		cout << "***** Cannot create Game with negative number of snakes!" << endl;
-		exit(1);
-	}
-	if (nSnakes > MAXSNAKES)
-	{
-		cout << "***** Cannot create Game with " << nSnakes
-			<< " snakes; only " << MAXSNAKES << " are allowed!" << endl;
-		exit(1);
-	}
-	if (rows == 1 && cols == 1 && nSnakes > 0)
-	{
-		cout << "***** Cannot create Game with nowhere to place the snakes!" << endl;
-		exit(1);
-	}
-
-	// Create pit
-	m_pit = new Pit(rows, cols);
-
-	// Add player
-	int rPlayer = 1 + rand() % rows;
-	int cPlayer = 1 + rand() % cols;
-	m_pit->addPlayer(rPlayer, cPlayer);
-
-	// Populate with snakes
-	while (nSnakes > 0)
-	{
-		int r = 1 + rand() % rows;
-		int c = 1 + rand() % cols;
-		// Don't put a snake where the player is
-		if (r == rPlayer  &&  c == cPlayer)
-			continue;
-		m_pit->addSnake(r, c);
-		nSnakes--;
-	}
-	//m_history = &m_pit->history();
-}
-
-Game::~Game()
-{
-	delete m_pit;
-}
-
-void Game::play()
-{
-	Player* p = m_pit->player();
-	if (p == nullptr)
-	{
-		m_pit->display("");
-		return;
-	}
-	string msg = "";
-	while (!m_pit->player()->isDead() && m_pit->snakeCount() > 0)
-	{
-		m_pit->display(msg);
-		msg = "";
-		cout << endl;
-		cout << "Move (u/d/l/r//h/q): ";
-		string action;
-		getline(cin, action);
-		if (action.size() == 0)
-			p->stand();
-		else
-		{
-			switch (action[0])
-			{
-			default:   // if bad move, nobody moves
-				cout << '\a' << endl;  // beep
-				continue;
-			case 'q':
-				return;
-			case 'u':
-			case 'd':
-			case 'l':
-			case 'r':
-				p->move(decodeDirection(action[0]));
-				break;
-			case 'h':
-				m_pit->history().display();
-				//m_history->display();
-				cout << "Press enter to continue.";
-				cin.ignore(10000, '\n');
-				break;
-			}
-		}
-		m_pit->moveSnakes();
-	}
-	m_pit->display(msg);
-}
\ No newline at end of file
+#include "Game.h"
+#include "globals.h"
+#include "Player.h"
+#include "Pit.h"
+#include "Frame.h"
+#include "Renderer.h"
+#include "Snapshot.h"
+#include "Journal.h"
+#include <iostream>
+#include <cstdlib>
+#include <thread>
+#include <chrono>
+using namespace std;
+
+namespace
+{
+	const int PLAYUNDOTURNS = 100;  // turns 'b' can take back at the console
+}
+
+Game::Game(int rows, int cols, int nSnakes, bool hunting)
+{
+	if (nSnakes < 0)
+	{
+		cout << "***** Cannot create Game with negative number of snakes!" << endl;
+		exit(1);
+	}
+	if (nSnakes > MAXSNAKES)
+	{
+		cout << "***** Cannot create Game with " << nSnakes
+			<< " snakes; only " << MAXSNAKES << " are allowed!" << endl;
+		exit(1);
+	}
+	if (rows == 1 && cols == 1 && nSnakes > 0)
+	{
+		cout << "***** Cannot create Game with nowhere to place the snakes!" << endl;
+		exit(1);
+	}
+
+	m_quit = false;
+	m_journal = nullptr;
+
+	// Create pit
+	m_pit = new Pit(rows, cols);
+	m_pit->setHunting(hunting);
+
+	// Add player
+	int rPlayer = 1 + m_pit->randInt(rows);
+	int cPlayer = 1 + m_pit->randInt(cols);
+	m_pit->addPlayer(rPlayer, cPlayer);
+
+	// Populate with snakes, but not where the player is
+	m_pit->spawnSnakes(nSnakes, rPlayer, cPlayer);
+	//m_history = &m_pit->history();
+}
+
+Game::~Game()
+{
+	delete m_pit;
+	delete m_journal;
+}
+
+bool Game::save(const string& path) const
+{
+	return Snapshot::save(*m_pit, path);
+}
+
+bool Game::restore(const string& path)
+{
+	// Carry on from a snapshot written by save; on failure the current
+	// game is left as it was
+	Pit* saved = Snapshot::load(path);
+	if (saved == nullptr)
+		return false;
+	delete m_pit;
+	m_pit = saved;
+	m_quit = false;
+	if (m_journal != nullptr)
+	{
+		m_journal->clear();  // its turns were for the old pit
+		m_pit->journalTo(m_journal);
+	}
+	return true;
+}
+
+void Game::enableUndo(int maxTurns)
+{
+	// Keep a journal of the last maxTurns turns from now on, so undo can
+	// take them back
+	if (m_journal == nullptr)
+		m_journal = new Journal(maxTurns);
+	else
+		*m_journal = Journal(maxTurns);
+	m_pit->journalTo(m_journal);
+}
+
+int Game::undo(int nTurns)
+{
+	// Take back up to nTurns turns; returns how many were.  Quitting is
+	// not a turn, so it is forgotten too.
+	int undone = 0;
+	while (undone < nTurns && m_pit->undoTurn())
+		undone++;
+	m_quit = false;
+	return undone;
+}
+
+Pit* Game::pit()
+{
+	return m_pit;
+}
+
+bool Game::isOver() const
+{
+	const Player* p = m_pit->player();
+	return m_quit || p == nullptr || p->isDead() || m_pit->snakeCount() == 0;
+}
+
+void Game::render(ostream& out, string msg) const
+{
+	m_pit->render(out, msg);
+}
+
+size_t Game::memoryUsage() const
+{
+	return sizeof(Game) + m_pit->memoryUsage();
+}
+
+bool Game::takeTurn(const string& action)
+{
+	// Play one turn for the command typed at the prompt.  Returns false
+	// (and nobody moves) if the command is not recognized.
+	if (action.size() == 0)
+		return takeTurn(STAND);
+	if (action[0] == 'q')
+		return takeTurn(QUIT);
+	if (action[0] == 'h')  // the caller shows the history; the snakes still move
+		return takeTurn(PASS);
+	int dir = decodeDirection(action[0]);
+	return dir >= 0 && takeTurn(dir);
+}
+
+bool Game::takeTurn(int move)
+{
+	// Play one turn for a policy's move.  Returns false (and nobody
+	// moves) if it isn't one of the moves in Policy.h.
+	if (move == QUIT)
+	{
+		m_quit = true;
+		return true;
+	}
+	if (move < PASS || move > RIGHT)
+		return false;
+
+	Player* p = m_pit->player();
+	m_pit->markTurn();  // does nothing unless undo is enabled
+	if (move == STAND)
+		p->stand();
+	else if (move != PASS)
+		p->move(move);
+	m_pit->moveSnakes();
+	return true;
+}
+
+GameTask Game::session(ostream& out, bool console)
+{
+	// The game loop as a coroutine: it suspends at each prompt until the
+	// next command line is supplied.  On the console the screen is
+	// cleared before each display, as play has always done.  Otherwise
+	// (GameServer) the prompt ends its line and the history is shown
+	// without waiting for enter, so a client can read whole lines.  If
+	// undo is enabled, 'b' takes back the last turn.
+	if (m_pit->player() == nullptr)
+	{
+		if (console)
+			clearScreen();
+		render(out, "");
+		co_return;
+	}
+	string msg = "";
+	while (!isOver())
+	{
+		if (console)
+			clearScreen();
+		render(out, msg);
+		msg = "";
+		const char* prompt = (m_journal != nullptr ? "Move (u/d/l/r//h/b/q): " : "Move (u/d/l/r//h/q): ");
+		if (console)
+		{
+			out << endl;
+			out << prompt;
+		}
+		else
+			out << prompt << endl;
+		string action = co_await GameTask::NextLine();
+		if (action.size() > 0 && action[0] == 'b')
+		{
+			if (undo(1) == 1)
+				msg = "Took back a turn.";
+			else
+				out << '\a' << endl;  // beep: nothing to take back
+			continue;
+		}
+		if (action.size() > 0 && action[0] == 'h')
+		{
+			if (console)
+				clearScreen();
+			m_pit->history().render(out);
+			if (console)
+			{
+				out << "Press enter to continue.";
+				co_await GameTask::NextLine();
+			}
+		}
+		if (!takeTurn(action))
+			out << '\a' << endl;  // beep
+	}
+	if (!m_quit)
+	{
+		if (console)
+			clearScreen();
+		render(out, msg);
+	}
+}
+
+void Game::showTurn(Renderer* preview, int msPerTurn, bool last)
+{
+	// For autoplay: send the pit to the preview (its last frame if the
+	// game is over), then wait out the rest of the turn
+	if (preview != nullptr)
+	{
+		Frame frame;
+		m_pit->snapshot(frame, "");
+		if (last)
+			preview->finish(frame);
+		else
+			preview->show(frame);
+	}
+	if (msPerTurn > 0)
+		this_thread::sleep_for(chrono::milliseconds(msPerTurn));
+}
+
+void Game::play()
+{
+	enableUndo(PLAYUNDOTURNS);
+	GameTask task = session(cout, true);
+	while (!task.done())
+	{
+		string action;
+		if (!getline(cin, action))
+			action = "q";  // no one left to type
+		task.resume(action);
+	}
+}
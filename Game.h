@@ -1,23 +1,88 @@
-#ifndef GAME_H
-
-#define GAME_H
-
-class Pit;
-class History;
-
-class Game
-{
-public:
-	// Constructor/destructor
-	Game(int rows, int cols, int nSnakes);
-	~Game();
-
-	// Mutators
-	void play();
-
-private:
-	Pit* m_pit;
-//	History* m_history;
-};
-
-#endif
\ No newline at end of file
+#ifndef GAME_H
+
+#define GAME_H
+
+#include <string>
+#include <iosfwd>
+#include <climits>
+#include "GameTask.h"
+#include "Policy.h"
+
+class Pit;
+class History;
+class Renderer;
+class Journal;
+
+class Game
+{
+public:
+	// Constructor/destructor
+	Game(int rows, int cols, int nSnakes, bool hunting = false);
+	~Game();
+
+	// Accessors
+	bool   isOver() const;
+	void   render(std::ostream& out, std::string msg) const;
+	size_t memoryUsage() const;
+	bool   save(const std::string& path) const;
+
+	// Mutators
+	void play();
+	GameTask session(std::ostream& out, bool console = false);
+	bool takeTurn(const std::string& action);
+	bool takeTurn(int move);
+	template <typename Policy>
+	int  run(Policy& policy, int maxTurns = INT_MAX);
+	template <typename Policy>
+	int  autoplay(Policy& policy, int maxTurns, int msPerTurn, Renderer* preview);
+	bool restore(const std::string& path);
+	void enableUndo(int maxTurns);
+	int  undo(int nTurns);
+	Pit* pit();
+
+private:
+	Pit* m_pit;
+	bool m_quit;
+	Journal* m_journal;  // null unless undo is enabled
+//	History* m_history;
+
+	void showTurn(Renderer* preview, int msPerTurn, bool last);
+};
+
+template <typename Policy>
+int Game::run(Policy& policy, int maxTurns)
+{
+	// Play until the game is over, the policy quits or chooses a move
+	// that isn't one (see Policy.h), or maxTurns turns have been played.
+	// Returns the number of turns.
+	int turns = 0;
+	while (!isOver() && turns < maxTurns)
+	{
+		int move = policy.choose(*m_pit);
+		if (!takeTurn(move) || move == QUIT)
+			break;
+		turns++;
+	}
+	return turns;
+}
+
+template <typename Policy>
+int Game::autoplay(Policy& policy, int maxTurns, int msPerTurn, Renderer* preview)
+{
+	// Play without a human, one run turn at a time.  If msPerTurn > 0,
+	// turns are paced in real time.  Frames go to the preview's thread,
+	// so drawing them never delays the simulation.  Returns the number
+	// of turns played.
+	if (isOver())
+		return 0;
+	int turns = 0;
+	while (turns < maxTurns && run(policy, 1) == 1)
+	{
+		turns++;
+		showTurn(preview, msPerTurn, false);
+	}
+	showTurn(preview, 0, true);
+	return turns;
+}
+
+#endif
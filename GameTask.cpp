@@ -0,0 +1,103 @@
+#include "GameTask.h"
+#include <exception>
+#include <new>
+#include <utility>
+using namespace std;
+
+namespace
+{
+	// Coroutine frames are rounded up to a multiple of FRAMEALIGN bytes
+	// and recycled through one free list per size class.  Frames bigger
+	// than the largest class fall back to the global heap.
+	const size_t FRAMEALIGN = 64;
+	const size_t NFRAMECLASSES = 32;  // frames up to 2 KB are pooled
+
+	struct FreeFrame
+	{
+		FreeFrame* next;
+	};
+
+	thread_local FreeFrame* freeFrames[NFRAMECLASSES];
+
+	size_t frameClass(size_t size)
+	{
+		return (size + FRAMEALIGN - 1) / FRAMEALIGN - 1;
+	}
+}
+
+void* GameTask::promise_type::operator new(size_t size)
+{
+	size_t k = frameClass(size);
+	if (k >= NFRAMECLASSES)
+		return ::operator new(size);
+	FreeFrame* f = freeFrames[k];
+	if (f == nullptr)
+		return ::operator new((k + 1) * FRAMEALIGN);
+	freeFrames[k] = f->next;
+	return f;
+}
+
+void GameTask::promise_type::operator delete(void* p, size_t size)
+{
+	size_t k = frameClass(size);
+	if (k >= NFRAMECLASSES)
+	{
+		::operator delete(p);
+		return;
+	}
+	FreeFrame* f = static_cast<FreeFrame*>(p);
+	f->next = freeFrames[k];
+	freeFrames[k] = f;
+}
+
+GameTask GameTask::promise_type::get_return_object()
+{
+	return GameTask(coroutine_handle<promise_type>::from_promise(*this));
+}
+
+void GameTask::promise_type::unhandled_exception()
+{
+	terminate();
+}
+
+GameTask::GameTask(coroutine_handle<promise_type> h)
+	: m_handle(h)
+{
+}
+
+GameTask::GameTask(GameTask&& other) noexcept
+	: m_handle(other.m_handle)
+{
+	other.m_handle = nullptr;
+}
+
+GameTask& GameTask::operator=(GameTask&& other) noexcept
+{
+	if (this != &other)
+	{
+		if (m_handle)
+			m_handle.destroy();
+		m_handle = other.m_handle;
+		other.m_handle = nullptr;
+	}
+	return *this;
+}
+
+GameTask::~GameTask()
+{
+	if (m_handle)
+		m_handle.destroy();
+}
+
+bool GameTask::done() const
+{
+	return !m_handle || m_handle.done();
+}
+
+void GameTask::resume(string line)
+{
+	if (done())
+		return;
+	m_handle.promise().input = std::move(line);
+	m_handle.resume();
+}
@@ -0,0 +1,60 @@
+#ifndef GAMETASK_H
+
+#define GAMETASK_H
+
+#include <coroutine>
+#include <cstddef>
+#include <string>
+
+// A game suspended while it waits for the player's next command.  The
+// coroutine runs until it first needs input; after that, each resume()
+// hands it one line and runs it to the next prompt (or to the end).
+// Frames are recycled through a per-thread pool, so creating and
+// destroying tens of thousands of games doesn't go through malloc.
+class GameTask
+{
+public:
+	struct promise_type
+	{
+		std::string input;
+
+		GameTask get_return_object();
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception();
+
+		static void* operator new(std::size_t size);
+		static void operator delete(void* p, std::size_t size);
+	};
+
+	// co_await GameTask::NextLine() suspends until resume() supplies a line
+	struct NextLine
+	{
+		std::coroutine_handle<promise_type> m_handle;
+
+		bool await_ready() const noexcept { return false; }
+		void await_suspend(std::coroutine_handle<promise_type> h) noexcept { m_handle = h; }
+		std::string await_resume() { return std::move(m_handle.promise().input); }
+	};
+
+	// Constructors/destructor
+	GameTask(GameTask&& other) noexcept;
+	GameTask& operator=(GameTask&& other) noexcept;
+	~GameTask();
+
+	// Accessors
+	bool done() const;
+
+	// Mutators
+	void resume(std::string line);
+
+private:
+	explicit GameTask(std::coroutine_handle<promise_type> h);
+	GameTask(const GameTask&) = delete;
+	GameTask& operator=(const GameTask&) = delete;
+
+	std::coroutine_handle<promise_type> m_handle;
+};
+
+#endif
@@ -0,0 +1,79 @@
+#include "GlobalHistory.h"
+#include <iostream>
+using namespace std;
+
+GlobalHistory::GlobalHistory()
+{
+	for (int k = 0; k < MAXROWS * MAXCOLS; k++)
+		m_totals[k] = 0;
+}
+
+GlobalHistory::~GlobalHistory()
+{
+	for (size_t b = 0; b < m_buffers.size(); b++)
+		delete [] m_buffers[b];
+}
+
+unsigned long long GlobalHistory::timesAt(int r, int c) const
+{
+	if (r < 1 || r > MAXROWS || c < 1 || c > MAXCOLS)
+		return 0;
+	return m_totals[(r - 1) * MAXCOLS + (c - 1)];
+}
+
+unsigned int* GlobalHistory::newBuffer()
+{
+	// The buffer lives as long as this GlobalHistory does
+	unsigned int* buffer = new unsigned int[MAXROWS * MAXCOLS]();
+	lock_guard<mutex> lock(m_mutex);
+	m_buffers.push_back(buffer);
+	return buffer;
+}
+
+void GlobalHistory::merge()
+{
+	// Straight-line loops over contiguous arrays, which the compiler
+	// turns into SIMD adds.  A kill taken back after the last merge
+	// leaves its buffer count below zero, which wraps around; adding it
+	// as a signed count takes it off the total.
+	lock_guard<mutex> lock(m_mutex);
+	unsigned long long* totals = m_totals;
+	for (size_t b = 0; b < m_buffers.size(); b++)
+	{
+		unsigned int* buffer = m_buffers[b];
+		for (int k = 0; k < MAXROWS * MAXCOLS; k++)
+			totals[k] += static_cast<int>(buffer[k]);
+		for (int k = 0; k < MAXROWS * MAXCOLS; k++)
+			buffer[k] = 0;
+	}
+}
+
+void GlobalHistory::clear()
+{
+	lock_guard<mutex> lock(m_mutex);
+	for (int k = 0; k < MAXROWS * MAXCOLS; k++)
+		m_totals[k] = 0;
+	for (size_t b = 0; b < m_buffers.size(); b++)
+		for (int k = 0; k < MAXROWS * MAXCOLS; k++)
+			m_buffers[b][k] = 0;
+}
+
+void GlobalHistory::render(ostream& out, int nRows, int nCols) const
+{
+	// Same letters as History::render
+	for (int r = 1; r <= nRows; r++)
+	{
+		for (int c = 1; c <= nCols; c++)
+		{
+			unsigned long long n = timesAt(r, c);
+			if (n == 0)
+				out << '.';
+			else if (n < 26)
+				out << static_cast<char>('A' + (n - 1));
+			else
+				out << 'Z';
+		}
+		out << endl;
+	}
+	out << endl;
+}
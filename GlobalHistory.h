@@ -0,0 +1,43 @@
+#ifndef GLOBALHISTORY_H
+
+#define GLOBALHISTORY_H
+
+#include <iosfwd>
+#include <mutex>
+#include <vector>
+#include "globals.h"
+
+// Kill counts summed over many games.  Each recording thread gets its
+// own buffer from newBuffer() and passes it to History::setThreadTotals;
+// from then on every History::record on that thread also bumps the
+// buffer, and every History::unrecord takes it back down, with no
+// sharing between threads.  merge() folds all buffers
+// into the totals and clears them.  Call it only while the recording
+// threads are between batches (or finished), since buffers are plain
+// counters.
+class GlobalHistory
+{
+public:
+	// Constructor/destructor
+	GlobalHistory();
+	~GlobalHistory();
+
+	// Accessors
+	unsigned long long timesAt(int r, int c) const;
+	void render(std::ostream& out, int nRows, int nCols) const;
+
+	// Mutators
+	unsigned int* newBuffer();
+	void merge();
+	void clear();
+
+private:
+	std::mutex m_mutex;  // guards m_buffers; never taken while recording
+	std::vector<unsigned int*> m_buffers;
+	unsigned long long m_totals[MAXROWS * MAXCOLS];  // [(r-1)*MAXCOLS + (c-1)]
+
+	GlobalHistory(const GlobalHistory&) = delete;
+	GlobalHistory& operator=(const GlobalHistory&) = delete;
+};
+
+#endif
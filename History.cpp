@@ -1,51 +1,209 @@
-#include "History.h"
-#include "globals.h"
-#include <iostream>
-using namespace std;
-
-History::History(int nRows, int nCols)
-{
-	m_rowsHistory = nRows;
-	m_colsHistory = nCols;
-	for (int r = 0; r < nRows; r++)
-	{
-		for (int c = 0; c < nCols; c++)
-			numTimesAtSpot[r][c] = 0;
-	}
-}
-
-bool History::record(int r, int c)
-{
-	if (r > m_rowsHistory || r < 1 || c > m_colsHistory || c < 1)
-		return false;
-	(numTimesAtSpot[r][c])++;
-	return true;
-}
-
-void History::display() const
-{
-	char historyGrid[MAXROWS][MAXCOLS];
-	int r, c;
-
-	for (r = 1; r <= m_rowsHistory; r++)
-		for (c = 1; c <= m_colsHistory; c++)
-		{
-			if (numTimesAtSpot[r][c] == 0)
-				historyGrid[r][c] = '.';
-			else if (numTimesAtSpot[r][c] > 0 && numTimesAtSpot[r][c] < 26)
-				historyGrid[r][c] = 'A' + (numTimesAtSpot[r][c] - 1);
-			else
-				historyGrid[r][c] = 'Z';
-		}
-
-	clearScreen();
-
-	// Draw the grid
-	for (r = 1; r <= m_rowsHistory; r++)
-	{
-		for (c = 1; c <= m_colsHistory; c++)
-			cout << historyGrid[r][c];
-		cout << endl;
-	}
-	cout << endl;
-}
+#include "History.h"
+#include "globals.h"
+#include <iostream>
+#include <algorithm>
+using namespace std;
+
+History::History(int nRows, int nCols)
+{
+	m_rowsHistory = nRows;
+	m_colsHistory = nCols;
+}
+
+namespace
+{
+	// This thread's GlobalHistory buffer, if any
+	thread_local unsigned int* threadTotals = nullptr;
+}
+
+unsigned int* History::setThreadTotals(unsigned int* totals)
+{
+	// From now on, kills recorded on this thread are also added to
+	// totals[(r-1)*MAXCOLS + (c-1)].  Returns the previous buffer.
+	unsigned int* previous = threadTotals;
+	threadTotals = totals;
+	return previous;
+}
+
+void History::countInThreadTotals(int r, int c)
+{
+	// A kill in a game that keeps its own counts (CompactGame), which
+	// the thread's totals should see all the same
+	if (threadTotals != nullptr && r >= 1 && r <= MAXROWS && c >= 1 && c <= MAXCOLS)
+		threadTotals[(r - 1) * MAXCOLS + (c - 1)]++;
+}
+
+bool History::record(int r, int c)
+{
+	if (r > m_rowsHistory || r < 1 || c > m_colsHistory || c < 1)
+		return false;
+	if (threadTotals != nullptr)
+		threadTotals[(r - 1) * MAXCOLS + (c - 1)]++;
+	int cell = (r - 1) * m_colsHistory + (c - 1);
+	if (!m_dense.empty())
+	{
+		if (m_dense[cell] < MAXKILLCOUNT)
+			m_dense[cell]++;
+		return true;
+	}
+
+	vector<SparseCount>::iterator p =
+		lower_bound(m_sparse.begin(), m_sparse.end(), cell, cellBefore);
+	if (p != m_sparse.end() && p->cell == cell)
+	{
+		if (p->count < MAXKILLCOUNT)
+			p->count++;
+		return true;
+	}
+	SparseCount sc;
+	sc.cell = static_cast<unsigned short>(cell);
+	sc.count = 1;
+	m_sparse.insert(p, sc);
+	if ((m_sparse.size() + 1) * sizeof(SparseCount) > static_cast<size_t>(m_rowsHistory * m_colsHistory))
+		makeDense();
+	return true;
+}
+
+bool History::cellBefore(const SparseCount& a, int cell)
+{
+	return a.cell < cell;
+}
+
+void History::unrecord(int r, int c, int count)
+{
+	// Take back one record at (r,c) (see Pit::undoTurn), setting the
+	// cell's count back to what it was before.  The thread's totals
+	// lose that kill too, or undone and tentative turns would leave
+	// kills there that never happened.
+	if (r > m_rowsHistory || r < 1 || c > m_colsHistory || c < 1)
+		return;
+	if (threadTotals != nullptr)
+		threadTotals[(r - 1) * MAXCOLS + (c - 1)]--;
+	int cell = (r - 1) * m_colsHistory + (c - 1);
+	if (!m_dense.empty())
+	{
+		m_dense[cell] = static_cast<unsigned char>(count);
+		return;
+	}
+	vector<SparseCount>::iterator p =
+		lower_bound(m_sparse.begin(), m_sparse.end(), cell, cellBefore);
+	bool present = (p != m_sparse.end() && p->cell == cell);
+	if (count == 0)
+	{
+		if (present)
+			m_sparse.erase(p);
+	}
+	else if (present)
+		p->count = static_cast<unsigned char>(count);
+	else
+	{
+		SparseCount sc;
+		sc.cell = static_cast<unsigned short>(cell);
+		sc.count = static_cast<unsigned char>(count);
+		m_sparse.insert(p, sc);
+	}
+}
+
+void History::exportCounts(unsigned char counts[]) const
+{
+	// Every cell's count, row by row: rows*cols bytes
+	int cells = m_rowsHistory * m_colsHistory;
+	if (!m_dense.empty())
+	{
+		copy(m_dense.begin(), m_dense.end(), counts);
+		return;
+	}
+	fill(counts, counts + cells, 0);
+	for (size_t k = 0; k < m_sparse.size(); k++)
+		counts[m_sparse[k].cell] = m_sparse[k].count;
+}
+
+void History::importCounts(const unsigned char counts[])
+{
+	// Replace every count with those laid out as by exportCounts, in
+	// whichever form record would have ended up using
+	int cells = m_rowsHistory * m_colsHistory;
+	size_t nonzero = cells - count(counts, counts + cells, 0);
+	m_sparse.clear();
+	m_dense.clear();
+	if ((nonzero + 1) * sizeof(SparseCount) > static_cast<size_t>(cells))
+	{
+		m_dense.assign(counts, counts + cells);
+		return;
+	}
+	m_sparse.reserve(nonzero);
+	for (int cell = 0; cell < cells; cell++)
+	{
+		if (counts[cell] == 0)
+			continue;
+		SparseCount sc;
+		sc.cell = static_cast<unsigned short>(cell);
+		sc.count = counts[cell];
+		m_sparse.push_back(sc);
+	}
+}
+
+void History::makeDense()
+{
+	m_dense.assign(m_rowsHistory * m_colsHistory, 0);
+	for (size_t k = 0; k < m_sparse.size(); k++)
+		m_dense[m_sparse[k].cell] = m_sparse[k].count;
+	vector<SparseCount>().swap(m_sparse);  // give back its memory
+}
+
+int History::timesAt(int r, int c) const
+{
+	if (r > m_rowsHistory || r < 1 || c > m_colsHistory || c < 1)
+		return 0;
+	int cell = (r - 1) * m_colsHistory + (c - 1);
+	if (!m_dense.empty())
+		return m_dense[cell];
+	vector<SparseCount>::const_iterator p =
+		lower_bound(m_sparse.begin(), m_sparse.end(), cell, cellBefore);
+	if (p != m_sparse.end() && p->cell == cell)
+		return p->count;
+	return 0;
+}
+
+bool History::isDense() const
+{
+	return !m_dense.empty();
+}
+
+size_t History::memoryUsage() const
+{
+	return sizeof(History) + m_sparse.capacity() * sizeof(SparseCount) + m_dense.capacity();
+}
+
+void History::display() const
+{
+	clearScreen();
+	render(cout);
+}
+
+void History::render(ostream& out) const
+{
+	char historyGrid[MAXROWS][MAXCOLS];
+	int r, c;
+
+	for (r = 1; r <= m_rowsHistory; r++)
+		for (c = 1; c <= m_colsHistory; c++)
+		{
+			int n = timesAt(r, c);
+			if (n == 0)
+				historyGrid[r - 1][c - 1] = '.';
+			else if (n > 0 && n < 26)
+				historyGrid[r - 1][c - 1] = 'A' + (n - 1);
+			else
+				historyGrid[r - 1][c - 1] = 'Z';
+		}
+
+	// Draw the grid
+	for (r = 1; r <= m_rowsHistory; r++)
+	{
+		for (c = 1; c <= m_colsHistory; c++)
+			out << historyGrid[r - 1][c - 1];
+		out << endl;
+	}
+	out << endl;
+}
@@ -1,21 +1,50 @@
-#ifndef HISTORY_H
-
-#define HISTORY_H
-class Player;
-class Snake;
-class Pit;
-#include "globals.h"
-class History
-{
-public:
-	History(int nRows, int nCols);
-	bool record(int r, int c);
-	void display() const;
-private:
-	Pit* m_pit;
-	int m_rowsHistory;
-	int m_colsHistory;
-	int numTimesAtSpot[MAXROWS][MAXCOLS]; //initialized to 0
-};
-
+#ifndef HISTORY_H
+
+#define HISTORY_H
+class Player;
+class Snake;
+class Pit;
+#include "globals.h"
+#include <iosfwd>
+#include <vector>
+#include <cstddef>
+
+const int MAXKILLCOUNT = 255;       // History counts saturate here
+
+// Counts of kills per cell.  While kills are few they are kept sparse
+// (a sorted list of the cells that have any); once that list would take
+// as much room as a byte per cell, History switches to a dense grid of
+// saturating one-byte counters.
+class History
+{
+public:
+	History(int nRows, int nCols);
+	bool record(int r, int c);
+	void unrecord(int r, int c, int count);
+	int  timesAt(int r, int c) const;
+	bool isDense() const;
+	size_t memoryUsage() const;
+	void display() const;
+	void render(std::ostream& out) const;
+	void exportCounts(unsigned char counts[]) const;
+	void importCounts(const unsigned char counts[]);
+
+	static unsigned int* setThreadTotals(unsigned int* totals);
+	static void countInThreadTotals(int r, int c);
+private:
+	struct SparseCount
+	{
+		unsigned short cell;  // (r-1)*cols + (c-1)
+		unsigned char  count;
+	};
+
+	int m_rowsHistory;
+	int m_colsHistory;
+	std::vector<SparseCount>   m_sparse;  // sorted by cell; used until m_dense is
+	std::vector<unsigned char> m_dense;   // [(r-1)*cols + (c-1)], or empty
+
+	void makeDense();
+	static bool cellBefore(const SparseCount& a, int cell);
+};
+
 #endif
\ No newline at end of file
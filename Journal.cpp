@@ -0,0 +1,99 @@
+#include "Journal.h"
+using namespace std;
+
+Journal::Journal(int maxTurns)
+{
+	m_maxTurns = (maxTurns > 0 ? maxTurns : 1);
+}
+
+int Journal::turns() const
+{
+	return static_cast<int>(m_marks.size());
+}
+
+size_t Journal::memoryUsage() const
+{
+	return sizeof(Journal) + m_marks.size() * sizeof(Mark) +
+		m_entries.size() * sizeof(Entry) + m_players.size() * sizeof(PlayerState);
+}
+
+void Journal::clear()
+{
+	m_marks.clear();
+	m_entries.clear();
+	m_players.clear();
+}
+
+void Journal::beginTurn(unsigned long long rng, int turn, int turnsSinceResort)
+{
+	// Forget the oldest turn to make room for this one
+	if (turns() == m_maxTurns)
+	{
+		const Mark& oldest = m_marks.front();
+		m_entries.erase(m_entries.begin(), m_entries.begin() + oldest.nEntries);
+		m_players.erase(m_players.begin(), m_players.begin() + oldest.nPlayers);
+		m_marks.pop_front();
+	}
+	Mark m;
+	m.rng = rng;
+	m.turn = turn;
+	m.turnsSinceResort = turnsSinceResort;
+	m.nEntries = 0;
+	m.nPlayers = 0;
+	m_marks.push_back(m);
+}
+
+void Journal::notePlayer(Player* player, int row, int col, int age, bool dead)
+{
+	if (m_marks.empty())
+		return;
+	PlayerState p;
+	p.player = player;
+	p.row = row;
+	p.col = col;
+	p.age = age;
+	p.dead = dead;
+	m_players.push_back(p);
+	m_marks.back().nPlayers++;
+}
+
+void Journal::note(const Entry& e)
+{
+	// Changes made before the first turn began can't be taken back
+	if (m_marks.empty())
+		return;
+	m_entries.push_back(e);
+	m_marks.back().nEntries++;
+}
+
+bool Journal::popEntry(Entry& e)
+{
+	// The latest turn's entries, last first; false once there are none
+	if (m_marks.empty() || m_marks.back().nEntries == 0)
+		return false;
+	e = m_entries.back();
+	m_entries.pop_back();
+	m_marks.back().nEntries--;
+	return true;
+}
+
+bool Journal::popPlayer(PlayerState& p)
+{
+	// The latest turn's players, last first; false once there are none
+	if (m_marks.empty() || m_marks.back().nPlayers == 0)
+		return false;
+	p = m_players.back();
+	m_players.pop_back();
+	m_marks.back().nPlayers--;
+	return true;
+}
+
+bool Journal::endUndo(Mark& m)
+{
+	// Drop the latest turn, once its entries and players are popped
+	if (m_marks.empty())
+		return false;
+	m = m_marks.back();
+	m_marks.pop_back();
+	return true;
+}
@@ -0,0 +1,75 @@
+#ifndef JOURNAL_H
+
+#define JOURNAL_H
+
+#include <deque>
+#include <cstddef>
+
+class Player;
+
+// What a pit changed, turn by turn, so turns can be taken back (see
+// Pit::journalTo and Pit::undoTurn).  Each turn starts with a mark
+// holding the few things that are cheaper to copy than to track (the
+// generator and the turn counters), followed by one entry per change
+// to the snakes or the kill history, in the order they were made, and
+// a player's state before each change to it.  Undoing a turn replays
+// its entries and player states backwards.  Only the last maxTurns
+// turns are kept.
+class Journal
+{
+public:
+	enum Kind { PLACE, UNPLACE, ADD, REMOVE, KILLCOUNT };
+
+	struct Entry
+	{
+		unsigned char kind;
+		unsigned char row;    // UNPLACE, REMOVE: where the snake was; KILLCOUNT: the cell
+		unsigned char col;
+		unsigned char count;  // KILLCOUNT: the cell's count before
+		short snake;          // index of the snake
+		short prev;           // UNPLACE: its neighbors in its cell's list
+		short next;
+	};
+
+	struct PlayerState
+	{
+		Player* player;
+		int  row;
+		int  col;
+		int  age;
+		bool dead;
+	};
+
+	struct Mark
+	{
+		unsigned long long rng;
+		int    turn;
+		int    turnsSinceResort;
+		size_t nEntries;
+		size_t nPlayers;
+	};
+
+	// Constructor
+	Journal(int maxTurns);
+
+	// Accessors
+	int    turns() const;
+	size_t memoryUsage() const;
+
+	// Mutators
+	void   clear();
+	void   beginTurn(unsigned long long rng, int turn, int turnsSinceResort);
+	void   notePlayer(Player* player, int row, int col, int age, bool dead);
+	void   note(const Entry& e);
+	bool   popEntry(Entry& e);
+	bool   popPlayer(PlayerState& p);
+	bool   endUndo(Mark& m);
+
+private:
+	int m_maxTurns;
+	std::deque<Mark>        m_marks;
+	std::deque<Entry>       m_entries;
+	std::deque<PlayerState> m_players;
+};
+
+#endif
@@ -1,178 +1,1048 @@
-#include "Pit.h"
-#include "Player.h"
-#include "Snake.h"
-#include "globals.h"
-#include "History.h"
-#include <iostream>
-using namespace std;
-
-Pit::Pit(int nRows, int nCols)
-	: m_history(nRows,nCols)
-{
-	if (nRows <= 0 || nCols <= 0 || nRows > MAXROWS || nCols > MAXCOLS)
-	{
-		cout << "***** Pit created with invalid size " << nRows << " by "
-			<< nCols << "!" << endl;
-		exit(1);
-	}
-	m_rows = nRows;
-	m_cols = nCols;
-	m_player = nullptr;
-	m_nSnakes = 0;
-}
-
-Pit::~Pit()
-{
-	for (int k = 0; k < m_nSnakes; k++)
-		delete m_snakes[k];
-	delete m_player;
-}
-
-int Pit::rows() const
-{
-	return m_rows;
-}
-
-int Pit::cols() const
-{
-	return m_cols;
-}
-
-Player* Pit::player() const
-{
-	return m_player;
-}
-
-int Pit::snakeCount() const
-{
-	return m_nSnakes;
-}
-
-History& Pit::history()
-{
-	return m_history;
-}
-
-int Pit::numberOfSnakesAt(int r, int c) const
-{
-	int count = 0;
-	for (int k = 0; k < m_nSnakes; k++)
-	{
-		const Snake* sp = m_snakes[k];
-		if (sp->row() == r  &&  sp->col() == c)
-			count++;
-	}
-	return count;
-}
-
-void Pit::display(string msg) const
-{
-	// Position (row,col) in the pit coordinate system is represented in
-	// the array element grid[row-1][col-1]
-	char grid[MAXROWS][MAXCOLS];
-	int r, c;
-
-	// Fill the grid with dots
-	for (r = 0; r < rows(); r++)
-		for (c = 0; c < cols(); c++)
-			grid[r][c] = '.';
-
-	// Indicate each snake's position
-	for (int k = 0; k < m_nSnakes; k++)
-	{
-		const Snake* sp = m_snakes[k];
-		char& gridChar = grid[sp->row() - 1][sp->col() - 1];
-		switch (gridChar)
-		{
-		case '.':  gridChar = 'S'; break;
-		case 'S':  gridChar = '2'; break;
-		case '9':  break;
-		default:   gridChar++; break;  // '2' through '8'
-		}
-	}
-
-	// Indicate player's position
-	if (m_player != nullptr)
-	{
-		char& gridChar = grid[m_player->row() - 1][m_player->col() - 1];
-		if (m_player->isDead())
-			gridChar = '*';
-		else
-			gridChar = '@';
-	}
-
-	// Draw the grid
-	clearScreen();
-	for (r = 0; r < rows(); r++)
-	{
-		for (c = 0; c < cols(); c++)
-			cout << grid[r][c];
-		cout << endl;
-	}
-	cout << endl;
-
-	// Write message, snake, and player info
-	cout << endl;
-	if (msg != "")
-		cout << msg << endl;
-	cout << "There are " << snakeCount() << " snakes remaining." << endl;
-	if (m_player == nullptr)
-		cout << "There is no player." << endl;
-	else
-	{
-		if (m_player->age() > 0)
-			cout << "The player has lasted " << m_player->age() << " steps." << endl;
-		if (m_player->isDead())
-			cout << "The player is dead." << endl;
-	}
-}
-
-bool Pit::addSnake(int r, int c)
-{
-	// Dynamically allocate a new Snake and add it to the pit
-	if (m_nSnakes == MAXSNAKES)
-		return false;
-	m_snakes[m_nSnakes] = new Snake(this, r, c);
-	m_nSnakes++;
-	return true;
-}
-
-bool Pit::addPlayer(int r, int c)
-{
-	// Don't add a player if one already exists
-	if (m_player != nullptr)
-		return false;
-
-	// Dynamically allocate a new Player and add it to the pit
-	m_player = new Player(this, r, c);
-	return true;
-}
-
-bool Pit::destroyOneSnake(int r, int c)
-{
-	for (int k = 0; k < m_nSnakes; k++)
-	{
-		if (m_snakes[k]->row() == r  &&  m_snakes[k]->col() == c)
-		{
-			delete m_snakes[k];
-			m_snakes[k] = m_snakes[m_nSnakes - 1];
-			m_nSnakes--;
-			return true;
-		}
-	}
-	return false;
-}
-
-bool Pit::moveSnakes()
-{
-	for (int k = 0; k < m_nSnakes; k++)
-	{
-		Snake* sp = m_snakes[k];
-		sp->move();
-		if (sp->row() == m_player->row() && sp->col() == m_player->col())
-			m_player->setDead();
-	}
-
-	// return true if the player is still alive, false otherwise
-	return !m_player->isDead();
+#include "Pit.h"
+#include "Player.h"
+#include "Snake.h"
+#include "globals.h"
+#include "History.h"
+#include "SharedState.h"
+#include "Frame.h"
+#include "FrameStream.h"
+#include "Analytics.h"
+#include "Journal.h"
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+using namespace std;
+
+namespace
+{
+	// A random-walking snake stays put only when the direction it picked
+	// is blocked by a wall, and a snake next to a cell moves into it with
+	// probability 1/4.  These tables hold (1 - walls/4)^n and (3/4)^n so
+	// the danger stencil is a pair of lookups per cell.
+	struct DangerTables
+	{
+		float staysClear[5][MAXSNAKES + 1];
+		float neighborsClear[MAXSNAKES + 1];
+
+		DangerTables()
+		{
+			for (int n = 0; n <= MAXSNAKES; n++)
+			{
+				for (int walls = 0; walls <= 4; walls++)
+					staysClear[walls][n] = static_cast<float>(pow(1.0 - walls / 4.0, n));
+				neighborsClear[n] = static_cast<float>(pow(0.75, n));
+			}
+		}
+	};
+
+	const DangerTables& dangerTables()
+	{
+		static const DangerTables tables;
+		return tables;
+	}
+}
+
+Pit::Pit(int nRows, int nCols)
+	: Pit(nRows, nCols, static_cast<unsigned long long>(rand()) << 32 | rand())
+{
+}
+
+Pit::Pit(int nRows, int nCols, unsigned long long seed)
+	: m_history(nRows,nCols)
+{
+	if (nRows <= 0 || nCols <= 0 || nRows > MAXROWS || nCols > MAXCOLS)
+	{
+		cout << "***** Pit created with invalid size " << nRows << " by "
+			<< nCols << "!" << endl;
+		exit(1);
+	}
+	m_rows = nRows;
+	m_cols = nCols;
+	m_nPlayers = 0;
+	m_resortInterval = 0;
+	m_turn = 0;
+	m_turnsSinceResort = 0;
+	m_hunting = false;
+	m_spectators = nullptr;
+	m_analytics = nullptr;
+	m_journal = nullptr;
+	m_recorder = nullptr;
+	seedRandom(seed);
+	for (int r = 0; r < MAXROWS; r++)
+	{
+		for (int c = 0; c < MAXCOLS; c++)
+		{
+			m_occupancy[r][c] = 0;
+			m_firstAtCell[r][c] = -1;
+		}
+		m_snakeBits[r] = 0;
+		m_livePlayerBits[r] = 0;
+	}
+}
+
+Pit::Pit(const Pit& other)
+	: m_history(other.m_history)
+{
+	// The same game, but with no spectators, analytics, journal or
+	// recorder: a scratch pit whose turns nobody else sees
+	m_rows = other.m_rows;
+	m_cols = other.m_cols;
+	m_nPlayers = 0;
+	m_resortInterval = other.m_resortInterval;
+	m_turn = other.m_turn;
+	m_turnsSinceResort = other.m_turnsSinceResort;
+	m_hunting = other.m_hunting;
+	m_rng = other.m_rng;
+	m_spectators = nullptr;
+	m_analytics = nullptr;
+	m_journal = nullptr;
+	m_recorder = nullptr;
+	m_players.reserve(other.m_nPlayers);
+	for (int k = 0; k < other.m_nPlayers; k++)
+	{
+		const Player* pp = other.m_players[k];
+		addPlayer(pp->row(), pp->col());
+		m_players[k]->restore(pp->row(), pp->col(), pp->age(), pp->isDead());
+	}
+	m_snakes.reserve(other.m_snakes.size());
+	for (size_t k = 0; k < other.m_snakes.size(); k++)  // same order, so the cell lists still hold
+	{
+		m_snakes.push_back(Snake(this, other.m_snakes[k].row(), other.m_snakes[k].col()));
+		m_nextAtCell[k] = other.m_nextAtCell[k];
+		m_prevAtCell[k] = other.m_prevAtCell[k];
+	}
+	for (int r = 0; r < MAXROWS; r++)
+	{
+		for (int c = 0; c < MAXCOLS; c++)
+		{
+			m_occupancy[r][c] = other.m_occupancy[r][c];
+			m_firstAtCell[r][c] = other.m_firstAtCell[r][c];
+			m_playerDistance[r][c] = other.m_playerDistance[r][c];
+		}
+		m_snakeBits[r] = other.m_snakeBits[r];
+		m_livePlayerBits[r] = other.m_livePlayerBits[r];
+	}
+}
+
+Pit::~Pit()
+{
+	for (int k = 0; k < m_nPlayers; k++)
+		delete m_players[k];
+}
+
+int Pit::rows() const
+{
+	return m_rows;
+}
+
+int Pit::cols() const
+{
+	return m_cols;
+}
+
+Player* Pit::player() const
+{
+	return player(0);
+}
+
+Player* Pit::player(int k) const
+{
+	if (k < 0 || k >= m_nPlayers)
+		return nullptr;
+	return m_players[k];
+}
+
+int Pit::playerCount() const
+{
+	return m_nPlayers;
+}
+
+int Pit::snakeCount() const
+{
+	return static_cast<int>(m_snakes.size());
+}
+
+size_t Pit::memoryUsage() const
+{
+	// Bytes owned by this pit, including the snakes and players it allocated
+	return sizeof(Pit) - sizeof(History) + m_history.memoryUsage() +
+		m_snakes.capacity() * sizeof(Snake) + m_players.capacity() * sizeof(Player*) +
+		m_nPlayers * sizeof(Player);
+}
+
+int Pit::turn() const
+{
+	return m_turn;
+}
+
+bool Pit::isHunting() const
+{
+	return m_hunting;
+}
+
+Analytics* Pit::analytics() const
+{
+	return m_analytics;
+}
+
+Journal* Pit::journal() const
+{
+	return m_journal;
+}
+
+History& Pit::history()
+{
+	return m_history;
+}
+
+const History& Pit::history() const
+{
+	return m_history;
+}
+
+int Pit::numberOfSnakesAt(int r, int c) const
+{
+	if (r < 1 || r > m_rows || c < 1 || c > m_cols)
+		return 0;
+	return m_occupancy[r - 1][c - 1];
+}
+
+bool Pit::hasSnakeAt(int r, int c) const
+{
+	// The bitboard answers the common "any snake here?" question without
+	// touching the counts; one unsigned compare per coordinate covers
+	// both walls
+	if (static_cast<unsigned int>(r - 1) >= static_cast<unsigned int>(m_rows) ||
+		static_cast<unsigned int>(c - 1) >= static_cast<unsigned int>(m_cols))
+		return false;
+	return (m_snakeBits[r - 1] >> (c - 1)) & 1;
+}
+
+int Pit::distanceToPlayer(int r, int c) const
+{
+	// Shortest path length from (r,c) to the nearest live player, or -1
+	// if there is none.  With a single player the pit is an open
+	// rectangle, so this is just the Manhattan distance; with several,
+	// moveSnakes builds the field by a multi-source BFS each turn.
+	if (m_nPlayers == 1)
+	{
+		if (m_players[0]->isDead())
+			return -1;
+		return abs(m_players[0]->row() - r) + abs(m_players[0]->col() - c);
+	}
+	if (m_nPlayers == 0 || r < 1 || r > m_rows || c < 1 || c > m_cols)
+		return -1;
+	return m_playerDistance[r - 1][c - 1];
+}
+
+void Pit::placeSnake(int k)
+{
+	// Keep the counts, the bitboard and the cell lists in step with
+	// snake k's position
+	int r = m_snakes[k].row() - 1;
+	int c = m_snakes[k].col() - 1;
+	if (m_journal != nullptr)
+	{
+		Journal::Entry e = { Journal::PLACE, 0, 0, 0, static_cast<short>(k), 0, 0 };
+		m_journal->note(e);
+	}
+	m_occupancy[r][c]++;
+	m_snakeBits[r] |= 1ULL << c;
+	int first = m_firstAtCell[r][c];
+	m_nextAtCell[k] = static_cast<short>(first);
+	m_prevAtCell[k] = -1;
+	if (first >= 0)
+		m_prevAtCell[first] = static_cast<short>(k);
+	m_firstAtCell[r][c] = static_cast<short>(k);
+}
+
+void Pit::unplaceSnake(int k)
+{
+	int r = m_snakes[k].row() - 1;
+	int c = m_snakes[k].col() - 1;
+	int next = m_nextAtCell[k];
+	int prev = m_prevAtCell[k];
+	if (m_journal != nullptr)
+	{
+		Journal::Entry e = { Journal::UNPLACE, static_cast<unsigned char>(r + 1),
+			static_cast<unsigned char>(c + 1), 0, static_cast<short>(k),
+			static_cast<short>(prev), static_cast<short>(next) };
+		m_journal->note(e);
+	}
+	if (--m_occupancy[r][c] == 0)
+		m_snakeBits[r] &= ~(1ULL << c);
+	if (next >= 0)
+		m_prevAtCell[next] = static_cast<short>(prev);
+	if (prev >= 0)
+		m_nextAtCell[prev] = static_cast<short>(next);
+	else
+		m_firstAtCell[r][c] = static_cast<short>(next);
+}
+
+void Pit::indexSnakes()
+{
+	// Rebuild the cell lists from scratch after the snakes were reordered
+	for (int r = 0; r < m_rows; r++)
+		for (int c = 0; c < m_cols; c++)
+			m_firstAtCell[r][c] = -1;
+	for (int k = snakeCount() - 1; k >= 0; k--)
+	{
+		int r = m_snakes[k].row() - 1;
+		int c = m_snakes[k].col() - 1;
+		int first = m_firstAtCell[r][c];
+		m_nextAtCell[k] = static_cast<short>(first);
+		m_prevAtCell[k] = -1;
+		if (first >= 0)
+			m_prevAtCell[first] = static_cast<short>(k);
+		m_firstAtCell[r][c] = static_cast<short>(k);
+	}
+}
+
+int Pit::wallsAround(int r, int c) const
+{
+	return (r == 1) + (r == m_rows) + (c == 1) + (c == m_cols);
+}
+
+double Pit::dangerAt(int r, int c, int rKilled, int cKilled) const
+{
+	// Probability that a player at (r,c) is killed by the next
+	// moveSnakes.  If (rKilled,cKilled) is given, one snake there is
+	// treated as already destroyed (the player is jumping it).
+	if (r < 1 || r > m_rows || c < 1 || c > m_cols)
+		return 0;
+	const int dr[4] = { -1, 1, 0, 0 };
+	const int dc[4] = { 0, 0, -1, 1 };
+	int neighbors = 0;
+	for (int d = 0; d < 4; d++)
+		neighbors += numberOfSnakesAt(r + dr[d], c + dc[d]);
+	int here = numberOfSnakesAt(r, c);
+	if (numberOfSnakesAt(rKilled, cKilled) > 0)
+	{
+		if (rKilled == r  &&  cKilled == c)
+			here--;
+		else if (abs(rKilled - r) + abs(cKilled - c) == 1)
+			neighbors--;
+	}
+	if (m_hunting)  // any hunting snake within one step will reach the player
+		return (here + neighbors > 0 ? 1 : 0);
+	const DangerTables& t = dangerTables();
+	return 1 - t.staysClear[wallsAround(r, c)][here] * t.neighborsClear[neighbors];
+}
+
+void Pit::dangerMap(float danger[MAXROWS][MAXCOLS]) const
+{
+	// Same probability as dangerAt for every cell, as a 5-point stencil
+	// over the occupancy grid.  The neighbor sums and wall counts are
+	// branch-free adds over a whole row of contiguous ints, which the
+	// compiler can vectorize; the probabilities themselves are then two
+	// table lookups per cell, which it can't.
+	const DangerTables& t = dangerTables();
+	static const int noSnakes[MAXCOLS] = { 0 };
+	int r, c;
+
+	// Walls on the left and right of each column, the same for every row
+	int colWalls[MAXCOLS];
+	for (c = 0; c < m_cols; c++)
+		colWalls[c] = (c == 0) + (c == m_cols - 1);
+
+	for (r = 0; r < m_rows; r++)
+	{
+		const int* above = (r > 0 ? m_occupancy[r - 1] : noSnakes);
+		const int* below = (r < m_rows - 1 ? m_occupancy[r + 1] : noSnakes);
+		const int* here = m_occupancy[r];
+		int neighbors[MAXCOLS];
+		int walls[MAXCOLS];
+		int rowWalls = (r == 0) + (r == m_rows - 1);
+
+		for (c = 0; c < m_cols; c++)
+			neighbors[c] = above[c] + below[c];
+		for (c = 0; c < m_cols; c++)
+			walls[c] = colWalls[c] + rowWalls;
+		for (c = 1; c < m_cols; c++)
+			neighbors[c] += here[c - 1];
+		for (c = 0; c < m_cols - 1; c++)
+			neighbors[c] += here[c + 1];
+		if (m_hunting)
+		{
+			for (c = 0; c < m_cols; c++)
+				danger[r][c] = (here[c] + neighbors[c] > 0 ? 1.0f : 0.0f);
+			continue;
+		}
+		for (c = 0; c < m_cols; c++)
+			danger[r][c] = 1 - t.staysClear[walls[c]][here[c]] * t.neighborsClear[neighbors[c]];
+	}
+}
+
+void Pit::display(string msg, bool showDanger) const
+{
+	clearScreen();
+	render(cout, msg, showDanger);
+}
+
+void Pit::render(ostream& out, string msg, bool showDanger) const
+{
+	Frame frame;
+	snapshot(frame, msg, showDanger);
+	frame.draw(out);
+	if (m_recorder != nullptr)
+		m_recorder->write(frame);
+}
+
+void Pit::snapshot(Frame& frame, string msg, bool showDanger) const
+{
+	// Position (row,col) in the pit coordinate system is represented in
+	// the array element grid[row-1][col-1]
+	int r, c;
+	frame.rows = m_rows;
+	frame.cols = m_cols;
+
+	// Fill the grid with dots
+	for (r = 0; r < rows(); r++)
+		for (c = 0; c < cols(); c++)
+			frame.grid[r][c] = '.';
+
+	// Indicate each snake's position
+	for (size_t k = 0; k < m_snakes.size(); k++)
+	{
+		const Snake* sp = &m_snakes[k];
+		char& gridChar = frame.grid[sp->row() - 1][sp->col() - 1];
+		switch (gridChar)
+		{
+		case '.':  gridChar = 'S'; break;
+		case 'S':  gridChar = '2'; break;
+		case '9':  break;
+		default:   gridChar++; break;  // '2' through '8'
+		}
+	}
+
+	// Indicate players' positions
+	frame.nAlive = 0;
+	for (int k = 0; k < m_nPlayers; k++)
+	{
+		const Player* pp = m_players[k];
+		char& gridChar = frame.grid[pp->row() - 1][pp->col() - 1];
+		if (pp->isDead())
+		{
+			if (gridChar != '@')
+				gridChar = '*';
+		}
+		else
+		{
+			gridChar = '@';
+			frame.nAlive++;
+		}
+	}
+
+	// Chance (in tenths) of a snake being in each cell next turn
+	frame.hasDanger = showDanger;
+	if (showDanger)
+	{
+		float danger[MAXROWS][MAXCOLS];
+		dangerMap(danger);
+		for (r = 0; r < rows(); r++)
+			for (c = 0; c < cols(); c++)
+			{
+				if (danger[r][c] <= 0)
+					frame.danger[r][c] = '.';
+				else if (danger[r][c] >= 1)
+					frame.danger[r][c] = '!';
+				else
+					frame.danger[r][c] = static_cast<char>('0' + static_cast<int>(danger[r][c] * 10));
+			}
+	}
+
+	// Message, snake, and player info
+	size_t len = msg.copy(frame.msg, MAXMSG);
+	frame.msg[len] = '\0';
+	frame.nSnakes = snakeCount();
+	frame.nPlayers = m_nPlayers;
+	frame.playerAge = (m_nPlayers > 0 ? player()->age() : 0);
+	frame.playerDead = (m_nPlayers > 0 && player()->isDead());
+}
+
+void Pit::exportObservation(unsigned char* out, int planeStride, int rowStride,
+	int colStride, int factor) const
+{
+	// Write the pit as NUMOBSPLANES planes of bytes (see globals.h) into
+	// a caller-owned buffer.  Element (plane, row, col) goes to
+	// out[plane*planeStride + row*rowStride + col*colStride], so any
+	// planar or interleaved layout can be filled in place.  With factor
+	// > 1 each factor x factor block of cells becomes one element
+	// holding the block's total; every value saturates at 255.
+	if (factor < 1)
+		factor = 1;
+	int outRows = (m_rows + factor - 1) / factor;
+	int outCols = (m_cols + factor - 1) / factor;
+	int sums[NUMOBSPLANES][MAXROWS][MAXCOLS];
+	int r, c;
+	for (int p = 0; p < NUMOBSPLANES; p++)
+		for (r = 0; r < outRows; r++)
+			for (c = 0; c < outCols; c++)
+				sums[p][r][c] = 0;
+
+	for (r = 0; r < m_rows; r++)
+		for (c = 0; c < m_cols; c++)
+		{
+			sums[OBS_SNAKES][r / factor][c / factor] += m_occupancy[r][c];
+			sums[OBS_KILLS][r / factor][c / factor] += m_history.timesAt(r + 1, c + 1);
+		}
+	for (int k = 0; k < m_nPlayers; k++)
+		if (!m_players[k]->isDead())
+			sums[OBS_PLAYERS][(m_players[k]->row() - 1) / factor][(m_players[k]->col() - 1) / factor]++;
+
+	for (int p = 0; p < NUMOBSPLANES; p++)
+		for (r = 0; r < outRows; r++)
+		{
+			unsigned char* row = out + p * planeStride + r * rowStride;
+			for (c = 0; c < outCols; c++)
+				row[c * colStride] = static_cast<unsigned char>(sums[p][r][c] > 255 ? 255 : sums[p][r][c]);
+		}
+}
+
+bool Pit::addSnake(int r, int c)
+{
+	if (m_snakes.size() == MAXSNAKES)
+		return false;
+	m_snakes.push_back(Snake(this, r, c));
+	if (m_journal != nullptr)
+	{
+		Journal::Entry e = { Journal::ADD, 0, 0, 0, static_cast<short>(snakeCount() - 1), 0, 0 };
+		m_journal->note(e);
+	}
+	placeSnake(snakeCount() - 1);
+	return true;
+}
+
+bool Pit::spawnSnakes(int n, int rExcluded, int cExcluded)
+{
+	// Add n snakes at random cells other than (rExcluded,cExcluded), or
+	// none if they won't all fit.  Each snake takes one draw over just
+	// the allowed cells, instead of a row and a column draw retried
+	// whenever they hit the excluded cell, and the storage grows once.
+	int cells = m_rows * m_cols;
+	int excluded = -1;
+	if (rExcluded >= 1 && rExcluded <= m_rows && cExcluded >= 1 && cExcluded <= m_cols)
+	{
+		excluded = (rExcluded - 1) * m_cols + (cExcluded - 1);
+		cells--;
+	}
+	if (n < 0 || snakeCount() + n > MAXSNAKES || (n > 0 && cells == 0))
+		return false;
+	m_snakes.reserve(m_snakes.size() + n);
+	for (int k = 0; k < n; k++)
+	{
+		int cell = randInt(cells);
+		if (excluded >= 0 && cell >= excluded)
+			cell++;  // skip over the excluded cell
+		addSnake(1 + cell / m_cols, 1 + cell % m_cols);
+	}
+	return true;
+}
+
+bool Pit::addPlayer(int r, int c)
+{
+	// Don't add a player if there's no room for one
+	if (m_nPlayers == MAXPLAYERS)
+		return false;
+
+	// Dynamically allocate a new Player and add it to the pit
+	m_players.push_back(new Player(this, r, c));
+	m_nPlayers++;
+	return true;
+}
+
+bool Pit::destroyOneSnake(int r, int c)
+{
+	// The cell's list gives a snake there without a scan; the last
+	// snake then takes its slot, and whoever pointed at the last one is
+	// repointed at the slot
+	if (r < 1 || r > m_rows || c < 1 || c > m_cols || m_firstAtCell[r - 1][c - 1] < 0)
+		return false;
+	int k = m_firstAtCell[r - 1][c - 1];
+	unplaceSnake(k);
+	if (m_journal != nullptr)
+	{
+		Journal::Entry e = { Journal::REMOVE, static_cast<unsigned char>(r),
+			static_cast<unsigned char>(c), 0, static_cast<short>(k), 0, 0 };
+		m_journal->note(e);
+	}
+	if (m_analytics != nullptr)
+		m_analytics->record(HEAT_SNAKEDEATHS, r, c);
+	int last = snakeCount() - 1;
+	if (k != last)
+	{
+		m_snakes[k] = m_snakes[last];
+		int next = m_nextAtCell[last];
+		int prev = m_prevAtCell[last];
+		m_nextAtCell[k] = static_cast<short>(next);
+		m_prevAtCell[k] = static_cast<short>(prev);
+		if (next >= 0)
+			m_prevAtCell[next] = static_cast<short>(k);
+		if (prev >= 0)
+			m_nextAtCell[prev] = static_cast<short>(k);
+		else
+			m_firstAtCell[m_snakes[k].row() - 1][m_snakes[k].col() - 1] = static_cast<short>(k);
+	}
+	m_snakes.pop_back();
+	return true;
+}
+
+void Pit::movePlayers(const int dirs[])
+{
+	// Players act in the order they were added, so when two of them go
+	// for the same snake the earlier one gets the kill
+	for (int k = 0; k < m_nPlayers; k++)
+	{
+		Player* pp = m_players[k];
+		if (pp->isDead())
+			continue;
+		if (dirs[k] >= UP && dirs[k] <= RIGHT)
+			pp->move(dirs[k]);
+		else
+			pp->stand();
+	}
+}
+
+void Pit::indexPlayers()
+{
+	// Mark the cells holding a live player so collisions are found with
+	// a bitwise AND instead of comparing against every player
+	int r, c;
+	for (r = 0; r < m_rows; r++)
+	{
+		m_livePlayerBits[r] = 0;
+		for (c = 0; c < m_cols; c++)
+			m_playerDistance[r][c] = -1;
+	}
+	for (int k = 0; k < m_nPlayers; k++)
+		if (!m_players[k]->isDead())
+			m_livePlayerBits[m_players[k]->row() - 1] |= 1ULL << (m_players[k]->col() - 1);
+	if (!m_hunting || m_nPlayers < 2)
+		return;
+
+	// Multi-source BFS from every live player for hunting snakes
+	static const int dr[4] = { -1, 1, 0, 0 };
+	static const int dc[4] = { 0, 0, -1, 1 };
+	int queue[MAXROWS * MAXCOLS];
+	int head = 0;
+	int tail = 0;
+	for (r = 0; r < m_rows; r++)
+		for (c = 0; c < m_cols; c++)
+			if ((m_livePlayerBits[r] >> c) & 1)
+			{
+				m_playerDistance[r][c] = 0;
+				queue[tail++] = r * MAXCOLS + c;
+			}
+	while (head < tail)
+	{
+		int cr = queue[head] / MAXCOLS;
+		int cc = queue[head] % MAXCOLS;
+		head++;
+		for (int d = 0; d < 4; d++)
+		{
+			int nr = cr + dr[d];
+			int nc = cc + dc[d];
+			if (nr < 0 || nr >= m_rows || nc < 0 || nc >= m_cols || m_playerDistance[nr][nc] >= 0)
+				continue;
+			m_playerDistance[nr][nc] = static_cast<signed char>(m_playerDistance[cr][cc] + 1);
+			queue[tail++] = nr * MAXCOLS + nc;
+		}
+	}
+}
+
+bool Pit::moveSnakes()
+{
+	indexPlayers();
+	for (size_t k = 0; k < m_snakes.size(); k++)
+	{
+		unplaceSnake(static_cast<int>(k));
+		m_snakes[k].move();
+		placeSnake(static_cast<int>(k));
+	}
+	m_turn++;
+	if (m_resortInterval > 0  &&  ++m_turnsSinceResort >= m_resortInterval)
+	{
+		resortSnakes();
+		m_turnsSinceResort = 0;
+	}
+
+	// A live player can't share a cell with a snake before the snakes
+	// move, so the cells where one ran into a live player are just the
+	// overlap of the two bitboards
+	bool anyHit = false;
+	unsigned long long hit[MAXROWS];
+	for (int r = 0; r < m_rows; r++)
+	{
+		hit[r] = m_snakeBits[r] & m_livePlayerBits[r];
+		anyHit |= (hit[r] != 0);
+	}
+
+	// return true if any player is still alive, false otherwise
+	bool anyAlive = false;
+	for (int k = 0; k < m_nPlayers; k++)
+	{
+		Player* pp = m_players[k];
+		if (anyHit && ((hit[pp->row() - 1] >> (pp->col() - 1)) & 1))
+			pp->setDead();
+		if (!pp->isDead())
+		{
+			anyAlive = true;
+			if (m_analytics != nullptr)
+				m_analytics->record(HEAT_VISITS, pp->row(), pp->col());
+		}
+	}
+	if (m_analytics != nullptr)
+		m_analytics->endTurn();
+	if (m_spectators != nullptr)
+		m_spectators->publish(*this);
+	return anyAlive;
+}
+
+int Pit::advance(int n)
+{
+	// Every live player stands while the snakes take up to n turns,
+	// stopping after the turn in which any player dies.  Returns the
+	// number of turns taken.  The result is exactly that of n rounds of
+	// stand() and moveSnakes(), but random-walking snakes don't depend
+	// on each other or on the (motionless) players, so the turns are
+	// fused: a chunk of steps' directions is drawn up front, in the
+	// order moveSnakes would draw them, and then each snake walks the
+	// whole chunk with its position in registers.
+	int nAlive = 0;
+	for (int k = 0; k < m_nPlayers; k++)
+		if (!m_players[k]->isDead())
+			nAlive++;
+	if (nAlive == 0)
+		return 0;
+	int turns = 0;
+	if (m_hunting || m_spectators != nullptr || m_resortInterval > 0)
+	{
+		// Hunting snakes draw a varying number of random numbers and
+		// spectators want every turn, so go one turn at a time
+		while (turns < n)
+		{
+			for (int k = 0; k < m_nPlayers; k++)
+				if (!m_players[k]->isDead())
+					m_players[k]->stand();
+			moveSnakes();
+			turns++;
+			int stillAlive = 0;
+			for (int k = 0; k < m_nPlayers; k++)
+				if (!m_players[k]->isDead())
+					stillAlive++;
+			if (stillAlive < nAlive)
+				break;
+		}
+		return turns;
+	}
+
+	// Deaths come early in crowded pits, so the chunk starts small and
+	// grows, to avoid drawing many directions that are never used
+	const int CHUNK = 64;  // most steps drawn at a time
+	int chunk = 4;
+	int nSnakes = snakeCount();
+	unsigned char dirs[CHUNK][MAXSNAKES];
+	unsigned long long rngAt[CHUNK + 1];  // generator state before each step
+	indexPlayers();
+	while (turns < n)
+	{
+		int steps = (n - turns < chunk ? n - turns : chunk);
+		if (chunk < CHUNK)
+			chunk *= 2;
+		for (int t = 0; t < steps; t++)
+		{
+			rngAt[t] = m_rng;
+			for (int k = 0; k < nSnakes; k++)
+				dirs[t][k] = static_cast<unsigned char>(randInt(4));
+		}
+		rngAt[steps] = m_rng;
+
+		// First find the earliest step on which a snake lands on a live
+		// player; each snake need only be followed up to that step
+		int deathStep = steps;
+		for (int k = 0; k < nSnakes; k++)
+		{
+			int r = m_snakes[k].row() - 1;
+			int c = m_snakes[k].col() - 1;
+			for (int t = 0; t < deathStep; t++)
+			{
+				int dir = dirs[t][k];
+				r += (dir == DOWN && r < m_rows - 1) - (dir == UP && r > 0);
+				c += (dir == RIGHT && c < m_cols - 1) - (dir == LEFT && c > 0);
+				if ((m_livePlayerBits[r] >> c) & 1)
+				{
+					deathStep = t;
+					break;
+				}
+			}
+		}
+
+		// Then move every snake through the steps actually taken, and
+		// update the counts, bitboard and cell lists once per chunk
+		int taken = (deathStep < steps ? deathStep + 1 : steps);
+		for (int k = 0; k < nSnakes; k++)
+		{
+			int r = m_snakes[k].row() - 1;
+			int c = m_snakes[k].col() - 1;
+			for (int t = 0; t < taken; t++)
+			{
+				int dir = dirs[t][k];
+				r += (dir == DOWN && r < m_rows - 1) - (dir == UP && r > 0);
+				c += (dir == RIGHT && c < m_cols - 1) - (dir == LEFT && c > 0);
+			}
+			unplaceSnake(k);
+			m_snakes[k].moveTo(r + 1, c + 1);
+			placeSnake(k);
+		}
+		m_rng = rngAt[taken];
+		m_turn += taken;
+
+		if (m_analytics != nullptr)
+		{
+			// Live players are seen standing where they are every turn,
+			// except one killed on the last
+			for (int t = 0; t < taken; t++)
+			{
+				for (int k = 0; k < m_nPlayers; k++)
+				{
+					Player* pp = m_players[k];
+					if (!pp->isDead() && (t < deathStep || !hasSnakeAt(pp->row(), pp->col())))
+						m_analytics->record(HEAT_VISITS, pp->row(), pp->col());
+				}
+				m_analytics->endTurn();
+			}
+		}
+		for (int k = 0; k < m_nPlayers; k++)
+		{
+			Player* pp = m_players[k];
+			if (pp->isDead())
+				continue;
+			for (int t = 0; t < taken; t++)
+				pp->stand();
+			if (taken > deathStep && hasSnakeAt(pp->row(), pp->col()))
+				pp->setDead();
+		}
+		turns += taken;
+		if (taken > deathStep)
+			break;
+	}
+	return turns;
+}
+
+void Pit::setHunting(bool hunting)
+{
+	m_hunting = hunting;
+}
+
+void Pit::setResortInterval(int turns)
+{
+	m_resortInterval = (turns > 0 ? turns : 0);
+	m_turnsSinceResort = 0;
+}
+
+void Pit::resortSnakes()
+{
+	// Random walks and swap-removals scatter neighboring snakes across
+	// m_snakes.  Put them back in Z-order (Morton order) of their cells,
+	// so snakes near each other in the pit are near each other in
+	// memory, with an LSD radix sort on the 12-bit Morton code: two
+	// counting passes of 6 bits each.  Snakes in the same cell are
+	// interchangeable, so which one a kill removes can't be told apart.
+	static_assert(MAXROWS <= 32 && MAXCOLS <= 64 && MAXSNAKES <= 256, "Morton code or order won't fit");
+	if (m_journal != nullptr)
+		return;  // the journal refers to snakes by their place in m_snakes
+	const int DIGITBITS = 6;
+	const int NBUCKETS = 1 << DIGITBITS;
+	int n = snakeCount();
+	unsigned short key[MAXSNAKES];
+	unsigned char order[2][MAXSNAKES];
+	for (int k = 0; k < n; k++)
+	{
+		unsigned int code = 0;
+		unsigned int r = m_snakes[k].row() - 1;  // < 32
+		unsigned int c = m_snakes[k].col() - 1;  // < 64
+		for (int b = 0; b < 6; b++)
+			code |= ((c >> b) & 1) << (2 * b) | ((r >> b) & 1) << (2 * b + 1);
+		key[k] = static_cast<unsigned short>(code);
+		order[0][k] = static_cast<unsigned char>(k);
+	}
+	for (int pass = 0; pass < 2; pass++)
+	{
+		const unsigned char* from = order[pass];
+		unsigned char* to = order[1 - pass];
+		int shift = pass * DIGITBITS;
+		int start[NBUCKETS] = {};
+		for (int k = 0; k < n; k++)
+			start[(key[k] >> shift) & (NBUCKETS - 1)]++;
+		for (int b = 0, sum = 0; b < NBUCKETS; b++)
+		{
+			int count = start[b];
+			start[b] = sum;
+			sum += count;
+		}
+		for (int k = 0; k < n; k++)
+			to[start[(key[from[k]] >> shift) & (NBUCKETS - 1)]++] = from[k];
+	}
+	vector<Snake> sorted;
+	sorted.reserve(m_snakes.capacity());
+	for (int k = 0; k < n; k++)
+		sorted.push_back(m_snakes[order[0][k]]);
+	m_snakes.swap(sorted);
+	indexSnakes();
+}
+
+void Pit::publishTo(SharedState* spectators)
+{
+	m_spectators = spectators;
+	if (m_spectators != nullptr)
+		m_spectators->publish(*this);
+}
+
+void Pit::recordTo(Analytics* analytics)
+{
+	m_analytics = analytics;
+}
+
+void Pit::recordKill(int r, int c)
+{
+	// Count a kill at (r,c) in the history, where the player landed
+	if (m_journal != nullptr)
+	{
+		Journal::Entry e = { Journal::KILLCOUNT, static_cast<unsigned char>(r),
+			static_cast<unsigned char>(c), static_cast<unsigned char>(m_history.timesAt(r, c)), 0, 0, 0 };
+		m_journal->note(e);
+	}
+	m_history.record(r, c);
+}
+
+void Pit::journalTo(Journal* journal)
+{
+	// Changes are journaled only between markTurn calls, and undoTurn
+	// assumes every change since the oldest kept mark was; so attach
+	// the journal before a turn and keep it until the game is done.
+	// Snakes aren't resorted while a journal is attached.
+	m_journal = journal;
+}
+
+void Pit::recordFramesTo(FrameWriter* recorder)
+{
+	m_recorder = recorder;
+}
+
+void Pit::markTurn()
+{
+	// Start a turn that undoTurn can take back
+	if (m_journal == nullptr)
+		return;
+	m_journal->beginTurn(m_rng, m_turn, m_turnsSinceResort);
+}
+
+bool Pit::undoTurn()
+{
+	// Put the pit back as it was at the latest markTurn, replaying the
+	// journaled changes backwards.  Each entry's inverse finds the lists
+	// exactly as the change left them, since everything after it has
+	// already been undone.  Analytics and spectators aren't told.
+	if (m_journal == nullptr || m_journal->turns() == 0)
+		return false;
+	Journal::Entry e;
+	while (m_journal->popEntry(e))
+	{
+		int k = e.snake;
+		switch (e.kind)
+		{
+		case Journal::PLACE:
+		{
+			// Snake k is at the head of its cell's list
+			int r = m_snakes[k].row() - 1;
+			int c = m_snakes[k].col() - 1;
+			if (--m_occupancy[r][c] == 0)
+				m_snakeBits[r] &= ~(1ULL << c);
+			m_firstAtCell[r][c] = m_nextAtCell[k];
+			if (m_nextAtCell[k] >= 0)
+				m_prevAtCell[m_nextAtCell[k]] = -1;
+			break;
+		}
+		case Journal::UNPLACE:
+		{
+			// Relink snake k where it was, between prev and next
+			int r = e.row - 1;
+			int c = e.col - 1;
+			m_snakes[k].moveTo(e.row, e.col);
+			m_occupancy[r][c]++;
+			m_snakeBits[r] |= 1ULL << c;
+			m_prevAtCell[k] = e.prev;
+			m_nextAtCell[k] = e.next;
+			if (e.prev >= 0)
+				m_nextAtCell[e.prev] = static_cast<short>(k);
+			else
+				m_firstAtCell[r][c] = static_cast<short>(k);
+			if (e.next >= 0)
+				m_prevAtCell[e.next] = static_cast<short>(k);
+			break;
+		}
+		case Journal::ADD:
+			m_snakes.pop_back();
+			break;
+		case Journal::REMOVE:
+		{
+			// Move the snake that filled slot k back to the end, where
+			// it came from; slot k gets its own snake back, to be
+			// relinked by the UNPLACE before this entry
+			int last = snakeCount();
+			if (k == last)
+			{
+				m_snakes.push_back(Snake(this, e.row, e.col));
+				break;
+			}
+			m_snakes.push_back(m_snakes[k]);
+			int next = m_nextAtCell[k];
+			int prev = m_prevAtCell[k];
+			m_nextAtCell[last] = static_cast<short>(next);
+			m_prevAtCell[last] = static_cast<short>(prev);
+			if (next >= 0)
+				m_prevAtCell[next] = static_cast<short>(last);
+			if (prev >= 0)
+				m_nextAtCell[prev] = static_cast<short>(last);
+			else
+				m_firstAtCell[m_snakes[last].row() - 1][m_snakes[last].col() - 1] = static_cast<short>(last);
+			m_snakes[k].moveTo(e.row, e.col);
+			break;
+		}
+		case Journal::KILLCOUNT:
+			m_history.unrecord(e.row, e.col, e.count);
+			break;
+		}
+	}
+	Journal::PlayerState ps;
+	while (m_journal->popPlayer(ps))
+		ps.player->restore(ps.row, ps.col, ps.age, ps.dead);
+	Journal::Mark m;
+	m_journal->endUndo(m);
+	m_rng = m.rng;
+	m_turn = m.turn;
+	m_turnsSinceResort = m.turnsSinceResort;
+	return true;
+}
+
+void Pit::seedRandom(unsigned long long seed)
+{
+	// Each pit has its own generator so games are reproducible from a
+	// seed and can run on different threads without sharing rand()'s
+	// state.  The seed is scrambled (splitmix64) so nearby seeds give
+	// unrelated games.
+	seed += 0x9E3779B97F4A7C15ULL;
+	seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBULL;
+	seed ^= seed >> 31;
+	m_rng = (seed != 0 ? seed : 1);
+}
+
+int Pit::randInt(int limit)
+{
+	// Uniform-enough integer in [0, limit) from xorshift64*
+	m_rng ^= m_rng >> 12;
+	m_rng ^= m_rng << 25;
+	m_rng ^= m_rng >> 27;
+	return static_cast<int>(((m_rng * 0x2545F4914F6CDD1DULL) >> 32) % limit);
 }
\ No newline at end of file
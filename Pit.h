@@ -1,42 +1,110 @@
-#ifndef PIT_H
-
-#define PIT_H
-
-class Player;
-class Snake;
-#include <string>
-#include "globals.h"
-#include "History.h"
-
-class Pit
-{
-public:
-	// Constructor/destructor
-	Pit(int nRows, int nCols);
-	~Pit();
-
-	// Accessors
-	int     rows() const;
-	int     cols() const;
-	Player* player() const;
-	History& history();
-	int     snakeCount() const;
-	int     numberOfSnakesAt(int r, int c) const;
-	void    display(std::string msg) const;
-
-	// Mutators
-	bool   addSnake(int r, int c);
-	bool   addPlayer(int r, int c);
-	bool   destroyOneSnake(int r, int c);
-	bool   moveSnakes();
-
-private:
-	int     m_rows;
-	int     m_cols;
-	Player* m_player;
-	Snake*  m_snakes[MAXSNAKES];
-	int     m_nSnakes;
-	History m_history;
-};
-
+#ifndef PIT_H
+
+#define PIT_H
+
+class Player;
+class SharedState;
+class Analytics;
+class Journal;
+class FrameWriter;
+struct Frame;
+#include <string>
+#include <iosfwd>
+#include <vector>
+#include "globals.h"
+#include "History.h"
+#include "Snake.h"
+
+static_assert(MAXCOLS <= 64, "a pit row must fit in one bitboard word");
+static_assert(MAXROWS + MAXCOLS <= 127, "a distance in the pit must fit in a signed char");
+
+class Pit
+{
+public:
+	// Constructor/destructor
+	Pit(int nRows, int nCols);  // seeded from rand()
+	Pit(int nRows, int nCols, unsigned long long seed);
+	Pit(const Pit& other);  // without other's spectators, analytics, journal or recorder
+	~Pit();
+	Pit& operator=(const Pit&) = delete;
+
+	// Accessors
+	int     rows() const;
+	int     cols() const;
+	Player* player() const;
+	Player* player(int k) const;
+	int     playerCount() const;
+	History& history();
+	const History& history() const;
+	int     snakeCount() const;
+	int     turn() const;
+	bool    isHunting() const;
+	Analytics* analytics() const;
+	Journal* journal() const;
+	int     numberOfSnakesAt(int r, int c) const;
+	bool    hasSnakeAt(int r, int c) const;
+	int     distanceToPlayer(int r, int c) const;
+	double  dangerAt(int r, int c, int rKilled = 0, int cKilled = 0) const;
+	void    dangerMap(float danger[MAXROWS][MAXCOLS]) const;
+	void    display(std::string msg, bool showDanger = false) const;
+	void    render(std::ostream& out, std::string msg, bool showDanger = false) const;
+	void    snapshot(Frame& frame, std::string msg, bool showDanger = false) const;
+	void    exportObservation(unsigned char* out, int planeStride, int rowStride,
+	                          int colStride = 1, int factor = 1) const;
+	size_t  memoryUsage() const;
+
+	// Mutators
+	bool   addSnake(int r, int c);
+	bool   spawnSnakes(int n, int rExcluded = 0, int cExcluded = 0);
+	bool   addPlayer(int r, int c);
+	bool   destroyOneSnake(int r, int c);
+	void   movePlayers(const int dirs[]);
+	bool   moveSnakes();
+	int    advance(int n);
+	void   setHunting(bool hunting);
+	void   setResortInterval(int turns);
+	void   seedRandom(unsigned long long seed);
+	void   publishTo(SharedState* spectators);
+	void   recordTo(Analytics* analytics);
+	void   recordKill(int r, int c);
+	void   journalTo(Journal* journal);
+	void   recordFramesTo(FrameWriter* recorder);
+	void   markTurn();
+	bool   undoTurn();
+	int    randInt(int limit);
+
+private:
+	int     m_rows;
+	int     m_cols;
+	std::vector<Player*> m_players;  // at most MAXPLAYERS
+	int     m_nPlayers;          // m_players.size()
+	std::vector<Snake> m_snakes;  // stored by value, in no particular order
+	int     m_resortInterval;    // turns between Morton resorts; 0 for never
+	int     m_turn;              // turns the snakes have taken
+	int     m_turnsSinceResort;
+	bool    m_hunting;  // snakes chase the player instead of wandering
+	unsigned long long m_rng;  // xorshift64* state; nonzero
+	SharedState* m_spectators;  // published to after each moveSnakes; may be null
+	Analytics*   m_analytics;   // told about every visit and death; may be null
+	Journal*     m_journal;     // told about every change, for undoTurn; may be null
+	FrameWriter* m_recorder;    // sent every frame render draws; may be null
+	int     m_occupancy[MAXROWS][MAXCOLS];  // number of snakes at grid[row-1][col-1]
+	unsigned long long m_snakeBits[MAXROWS];  // bit col-1 of [row-1] set if m_occupancy > 0
+	unsigned long long m_livePlayerBits[MAXROWS];  // same layout; rebuilt by moveSnakes
+	short   m_firstAtCell[MAXROWS][MAXCOLS];  // index of a snake at grid[row-1][col-1], or -1
+	short   m_nextAtCell[MAXSNAKES];  // other snakes in the same cell, or -1
+	short   m_prevAtCell[MAXSNAKES];
+	signed char m_playerDistance[MAXROWS][MAXCOLS];  // to nearest live player, for hunting
+	History m_history;
+
+	int     wallsAround(int r, int c) const;
+	void    placeSnake(int k);
+	void    unplaceSnake(int k);
+	void    indexSnakes();
+	void    indexPlayers();
+	void    resortSnakes();
+
+	friend class Snapshot;
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,65 @@
+#ifndef PITFACTORY_H
+
+#define PITFACTORY_H
+
+#include <iostream>
+#include <cstdlib>
+#include "Pit.h"
+#include "Player.h"
+#include "FixedPit.h"
+
+// Sets up a new game in an empty pit of either kind: one player and
+// nSnakes snakes placed as Game::Game does, but drawing from the pit's
+// own generator seeded with seed, so the game is reproducible.  Returns
+// false (with the pit only partly set up) if the player or the snakes
+// don't fit.
+template <typename PitType>
+bool startPit(PitType& pit, int nSnakes, bool hunting, unsigned long long seed)
+{
+	pit.seedRandom(seed);
+	pit.setHunting(hunting);
+	int rPlayer = 1 + pit.randInt(pit.rows());
+	int cPlayer = 1 + pit.randInt(pit.cols());
+	return pit.addPlayer(rPlayer, cPlayer) && pit.spawnSnakes(nSnakes, rPlayer, cPlayer);
+}
+
+// startPit for callers that checked their arguments already; if the
+// game still doesn't fit, say so and stop, as Pit's constructor does
+template <typename PitType>
+void startPitOrExit(PitType& pit, int nSnakes, bool hunting, unsigned long long seed)
+{
+	if (!startPit(pit, nSnakes, hunting, seed))
+	{
+		std::cout << "***** Cannot start a " << pit.rows() << " by " << pit.cols()
+			<< " pit with " << nSnakes << " snakes!" << std::endl;
+		std::exit(1);
+	}
+}
+
+// Calls f with a started pit of the given size, using a FixedPit for
+// the sizes that have one and a Pit otherwise, and returns what f
+// returns.  f must accept either kind, e.g. a generic lambda:
+//     int age = withPit(9, 10, 15, false, seed, [](auto& pit) { ... });
+// The arguments must be valid for a Game of that size.  A FixedPit
+// holds as many snakes as a Pit can, so every such game fits.
+template <typename F>
+auto withPit(int rows, int cols, int nSnakes, bool hunting, unsigned long long seed, F f)
+{
+	if (rows == 9  &&  cols == 10)  // the default game
+	{
+		FixedPit<9, 10, MAXSNAKES> pit;
+		startPitOrExit(pit, nSnakes, hunting, seed);
+		return f(pit);
+	}
+	if (rows == 3  &&  cols == 3)  // the mini-game in main.cpp
+	{
+		FixedPit<3, 3, MAXSNAKES> pit;
+		startPitOrExit(pit, nSnakes, hunting, seed);
+		return f(pit);
+	}
+	Pit pit(rows, cols, seed);
+	startPitOrExit(pit, nSnakes, hunting, seed);
+	return f(pit);
+}
+
+#endif
@@ -1,98 +1,153 @@
-#include "Player.h"
-#include "Pit.h"
-#include <iostream>
-#include "History.h"
-#include "globals.h"
-using namespace std;
-
-Player::Player(Pit* pp, int r, int c)
-{
-	if (pp == nullptr)
-	{
-		cout << "***** The player must be in some Pit!" << endl;
-		exit(1);
-	}
-	if (r < 1 || r > pp->rows() || c < 1 || c > pp->cols())
-	{
-		cout << "**** Player created with invalid coordinates (" << r
-			<< "," << c << ")!" << endl;
-		exit(1);
-	}
-	m_pit = pp;
-	m_row = r;
-	m_col = c;
-	m_age = 0;
-	m_dead = false;
-	m_history = &m_pit->history();
-}
-
-int Player::row() const
-{
-	return m_row;
-}
-
-int Player::col() const
-{
-	return m_col;
-}
-
-int Player::age() const
-{
-	return m_age;
-}
-
-void Player::stand()
-{
-	m_age++;
-}
-
-void Player::move(int dir)
-{
-	m_age++;
-	int maxCanMove = 0;  // maximum distance player can move in direction dir
-	switch (dir)
-	{
-	case UP:     maxCanMove = m_row - 1;             break;
-	case DOWN:   maxCanMove = m_pit->rows() - m_row; break;
-	case LEFT:   maxCanMove = m_col - 1;             break;
-	case RIGHT:  maxCanMove = m_pit->cols() - m_col; break;
-	}
-	if (maxCanMove == 0)  // against wall
-		return;
-	int rowDelta;
-	int colDelta;
-	if (!directionToDeltas(dir, rowDelta, colDelta))
-		return;
-
-	// No adjacent snake in direction of movement
-
-	if (m_pit->numberOfSnakesAt(m_row + rowDelta, m_col + colDelta) == 0)
-	{
-		m_row += rowDelta;
-		m_col += colDelta;
-		return;
-	}
-
-	// Adjacent snake in direction of movement, so jump
-
-	if (maxCanMove >= 2)  // need a place to land
-	{
-		m_pit->destroyOneSnake(m_row + rowDelta, m_col + colDelta);
-		m_row += 2 * rowDelta;
-		m_col += 2 * colDelta;
-		if (m_pit->numberOfSnakesAt(m_row, m_col) > 0)  // landed on a snake!
-			setDead();
-		else
-			m_history->record(m_row, m_col);
-	}
-}
-
-bool Player::isDead() const
-{
-	return m_dead;
-}
-
-void Player::setDead()
-{
-	m_dead = true;
+#include "Player.h"
+#include "Pit.h"
+#include <iostream>
+#include "History.h"
+#include "Analytics.h"
+#include "Journal.h"
+#include "globals.h"
+using namespace std;
+
+Player::Player(Pit* pp, int r, int c)
+{
+	if (pp == nullptr)
+	{
+		cout << "***** The player must be in some Pit!" << endl;
+		exit(1);
+	}
+	if (r < 1 || r > pp->rows() || c < 1 || c > pp->cols())
+	{
+		cout << "**** Player created with invalid coordinates (" << r
+			<< "," << c << ")!" << endl;
+		exit(1);
+	}
+	m_pit = pp;
+	m_row = r;
+	m_col = c;
+	m_age = 0;
+	m_dead = false;
+}
+
+int Player::row() const
+{
+	return m_row;
+}
+
+int Player::col() const
+{
+	return m_col;
+}
+
+int Player::age() const
+{
+	return m_age;
+}
+
+void Player::stand()
+{
+	noteState();
+	m_age++;
+}
+
+void Player::move(int dir)
+{
+	noteState();
+	m_age++;
+	int maxCanMove = 0;  // maximum distance player can move in direction dir
+	switch (dir)
+	{
+	case UP:     maxCanMove = m_row - 1;             break;
+	case DOWN:   maxCanMove = m_pit->rows() - m_row; break;
+	case LEFT:   maxCanMove = m_col - 1;             break;
+	case RIGHT:  maxCanMove = m_pit->cols() - m_col; break;
+	}
+	if (maxCanMove == 0)  // against wall
+		return;
+	int rowDelta;
+	int colDelta;
+	if (!directionToDeltas(dir, rowDelta, colDelta))
+		return;
+
+	// No adjacent snake in direction of movement
+
+	if (!m_pit->hasSnakeAt(m_row + rowDelta, m_col + colDelta))
+	{
+		m_row += rowDelta;
+		m_col += colDelta;
+		return;
+	}
+
+	// Adjacent snake in direction of movement, so jump
+
+	if (maxCanMove >= 2)  // need a place to land
+	{
+		m_pit->destroyOneSnake(m_row + rowDelta, m_col + colDelta);
+		m_row += 2 * rowDelta;
+		m_col += 2 * colDelta;
+		if (m_pit->hasSnakeAt(m_row, m_col))  // landed on a snake!
+			setDead();
+		else
+			m_pit->recordKill(m_row, m_col);
+	}
+}
+
+double Player::risk(int dir) const
+{
+	// Chance of being dead after move(dir) (or stand(), if dir is not a
+	// direction) followed by the pit's moveSnakes, following the same
+	// rules as move
+	int maxCanMove = 0;
+	switch (dir)
+	{
+	case UP:     maxCanMove = m_row - 1;             break;
+	case DOWN:   maxCanMove = m_pit->rows() - m_row; break;
+	case LEFT:   maxCanMove = m_col - 1;             break;
+	case RIGHT:  maxCanMove = m_pit->cols() - m_col; break;
+	}
+	int rowDelta;
+	int colDelta;
+	if (maxCanMove == 0 || !directionToDeltas(dir, rowDelta, colDelta))
+		return m_pit->dangerAt(m_row, m_col);
+
+	int r = m_row + rowDelta;
+	int c = m_col + colDelta;
+	if (!m_pit->hasSnakeAt(r, c))
+		return m_pit->dangerAt(r, c);
+	if (maxCanMove < 2)  // nowhere to land, so the player stays put
+		return m_pit->dangerAt(m_row, m_col);
+	if (m_pit->hasSnakeAt(r + rowDelta, c + colDelta))  // would land on a snake
+		return 1;
+	return m_pit->dangerAt(r + rowDelta, c + colDelta, r, c);
+}
+
+bool Player::isDead() const
+{
+	return m_dead;
+}
+
+void Player::restore(int r, int c, int age, bool dead)
+{
+	// Put the player back in a saved state, without the side effects
+	// (kill history, analytics) of getting there
+	m_row = r;
+	m_col = c;
+	m_age = age;
+	m_dead = dead;
+}
+
+void Player::setDead()
+{
+	if (m_dead)
+		return;
+	noteState();
+	if (m_pit->analytics() != nullptr)
+		m_pit->analytics()->record(HEAT_PLAYERDEATHS, m_row, m_col);
+	m_dead = true;
+}
+
+void Player::noteState()
+{
+	// Before each change, so Pit::undoTurn can put the player back
+	Journal* journal = m_pit->journal();
+	if (journal != nullptr)
+		journal->notePlayer(this, m_row, m_col, m_age, m_dead);
 }
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "Policy.h"
+#include "Pit.h"
+#include "Player.h"
+#include <iostream>
+#include <cstdlib>
+using namespace std;
+
+//*********************************************************************
+//  ScriptedPolicy
+//*********************************************************************
+
+ScriptedPolicy::ScriptedPolicy(const string& moves)
+{
+	for (size_t k = 0; k < moves.size(); k++)
+	{
+		int move = (moves[k] == '.' ? STAND : decodeDirection(moves[k]));
+		if (moves[k] != '.' && move < 0)  // not STAND: decodeDirection's -1 for a typo
+		{
+			cout << "***** ScriptedPolicy created with invalid move '" << moves[k]
+				<< "' in \"" << moves << "\"!" << endl;
+			exit(1);
+		}
+		m_moves.push_back(move);
+	}
+	if (m_moves.empty())
+		m_moves.push_back(STAND);
+	m_next = 0;
+}
+
+//*********************************************************************
+//  GreedyPolicy
+//*********************************************************************
+
+int GreedyPolicy::choose(Pit& pit)
+{
+	const Player* p = pit.player();
+	int best = STAND;
+	double leastRisk = p->risk(STAND);
+	for (int dir = UP; dir <= RIGHT; dir++)
+	{
+		double risk = p->risk(dir);
+		if (risk < leastRisk)
+		{
+			leastRisk = risk;
+			best = dir;
+		}
+	}
+	return best;
+}
+
+//*********************************************************************
+//  SearchPolicy
+//*********************************************************************
+
+SearchPolicy::SearchPolicy(int depth, int samples)
+ : m_journal(depth > 0 ? depth : 1)
+{
+	m_depth = (depth > 0 ? depth : 1);
+	m_samples = (samples > 0 ? samples : 1);
+	m_seed = 1;
+}
+
+void SearchPolicy::start(unsigned long long seed)
+{
+	m_seed = seed;
+}
+
+int SearchPolicy::choose(Pit& pit)
+{
+	// Play the tries on a copy with none of the pit's sinks, so
+	// spectators, analytics and the pit's own journal see none of them;
+	// every try is taken back through this policy's journal
+	Pit scratch(pit);
+	scratch.journalTo(&m_journal);
+	const Player* p = pit.player();
+	int best = STAND;
+	int bestSurvived = -1;
+	double bestRisk = 0;
+	for (int move = STAND; move <= RIGHT; move++)
+	{
+		int survived = 0;
+		for (int k = 0; k < m_samples; k++)
+			survived += survivesTry(scratch, move);
+		if (survived < bestSurvived)
+			continue;
+		double risk = p->risk(move);
+		if (survived > bestSurvived || risk < bestRisk)
+		{
+			best = move;
+			bestSurvived = survived;
+			bestRisk = risk;
+		}
+	}
+	return best;
+}
+
+bool SearchPolicy::survivesTry(Pit& pit, int move)
+{
+	// The real snakes' moves come from the pit's generator, which a try
+	// mustn't peek at, so each try reseeds it (undoTurn puts it back)
+	Player* p = pit.player();
+	GreedyPolicy greedy;
+	int played = 0;
+	while (played < m_depth && !p->isDead() && pit.snakeCount() > 0)
+	{
+		pit.markTurn();
+		if (played == 0)
+			pit.seedRandom(m_seed++);
+		else
+			move = greedy.choose(pit);
+		if (move == STAND)
+			p->stand();
+		else
+			p->move(move);
+		pit.moveSnakes();
+		played++;
+	}
+	bool survived = !p->isDead();
+	while (played-- > 0)
+		pit.undoTurn();
+	return survived;
+}
@@ -0,0 +1,99 @@
+#ifndef POLICY_H
+
+#define POLICY_H
+
+#include <string>
+#include <vector>
+#include "globals.h"
+#include "Journal.h"
+
+class Pit;
+
+// What a policy can choose besides UP, DOWN, LEFT and RIGHT
+const int STAND = -1;  // stand still
+const int PASS = -2;   // do nothing while the snakes move ('h' at the prompt)
+const int QUIT = -3;   // end the game
+
+// A policy picks the first player's move each turn.  Policies aren't
+// related by inheritance: the game loops that use one (Game::run,
+// Game::autoplay, BatchRunner) are templates on the policy type, so
+// each turn's choose is a direct call that can be inlined.  Every
+// policy has
+//     void start(unsigned long long seed);  // a new game begins
+//     int  choose(Pit& pit);                // this turn's move
+// choose may change the pit while it thinks, but must leave it as it
+// found it.  A policy that never looks at the pit can take any kind of
+// pit instead (template <typename PitType> int choose(PitType&)); then
+// BatchRunner plays it on a FixedPit where there is one.
+
+// Plays a fixed sequence of moves over and over, written the way they
+// are typed ("udlr", with '.' to stand); any other character is an error
+class ScriptedPolicy
+{
+public:
+	ScriptedPolicy(const std::string& moves);
+	void start(unsigned long long) { m_next = 0; }
+	template <typename PitType>
+	int  choose(PitType&)
+	{
+		int move = m_moves[m_next];
+		m_next = (m_next + 1 < m_moves.size() ? m_next + 1 : 0);
+		return move;
+	}
+
+private:
+	std::vector<int> m_moves;
+	size_t           m_next;
+};
+
+// Stands or moves uniformly at random, from its own generator
+class RandomPolicy
+{
+public:
+	RandomPolicy() { start(1); }
+	void start(unsigned long long seed) { m_rng = seed * 0x9E3779B97F4A7C15ULL | 1; }
+	template <typename PitType>
+	int  choose(PitType&)
+	{
+		m_rng ^= m_rng >> 12;  // xorshift64*
+		m_rng ^= m_rng << 25;
+		m_rng ^= m_rng >> 27;
+		return static_cast<int>((m_rng * 2685821657736338717ULL >> 32) % 5) + STAND;
+	}
+
+private:
+	unsigned long long m_rng;
+};
+
+// Takes whichever move (or standing still) is least likely to get the
+// player killed this turn, according to Player::risk
+class GreedyPolicy
+{
+public:
+	void start(unsigned long long) {}
+	int  choose(Pit& pit);
+};
+
+// Looks further ahead than GreedyPolicy: tries each move followed by
+// depth-1 greedy turns, samples times each with freshly seeded snakes,
+// and takes the move that survived most often (the least risky one
+// among ties).  The tries are played on a copy of the pit, which has
+// no spectators, analytics or recorder attached, and taken back
+// through an undo journal of the policy's own.
+class SearchPolicy
+{
+public:
+	SearchPolicy(int depth = 3, int samples = 8);
+	void start(unsigned long long seed);
+	int  choose(Pit& pit);
+
+private:
+	int     m_depth;
+	int     m_samples;
+	unsigned long long m_seed;  // of the next try's snakes
+	Journal m_journal;
+
+	bool survivesTry(Pit& pit, int move);
+};
+
+#endif
@@ -0,0 +1,88 @@
+#include "Renderer.h"
+#include "globals.h"
+#include <iostream>
+using namespace std;
+
+FrameQueue::FrameQueue()
+	: m_back(0), m_pushed(0), m_middle(1), m_front(2), m_taken(0)
+{
+	for (int k = 0; k < 3; k++)
+		m_sequence[k] = 0;
+}
+
+void FrameQueue::push(const Frame& frame)
+{
+	m_frames[m_back] = frame;
+	m_sequence[m_back] = ++m_pushed;
+	m_back = m_middle.exchange(m_back | FRESH, memory_order_acq_rel) & ~FRESH;
+}
+
+int FrameQueue::popLatest(Frame& frame)
+{
+	if ((m_middle.load(memory_order_relaxed) & FRESH) == 0)
+		return -1;
+	m_front = m_middle.exchange(m_front, memory_order_acq_rel) & ~FRESH;
+	frame = m_frames[m_front];
+	int skipped = static_cast<int>(m_sequence[m_front] - m_taken - 1);
+	m_taken = m_sequence[m_front];
+	return skipped;
+}
+
+Renderer::Renderer(ostream& out, bool clear)
+	: m_out(out), m_clear(clear), m_signal(0), m_stopping(false), m_dropped(0)
+{
+	m_thread = thread(&Renderer::run, this);
+}
+
+Renderer::~Renderer()
+{
+	m_stopping.store(true);
+	wake();
+	m_thread.join();
+}
+
+long Renderer::framesDropped() const
+{
+	return m_dropped.load(memory_order_relaxed);
+}
+
+void Renderer::show(const Frame& frame)
+{
+	m_queue.push(frame);
+	wake();
+}
+
+void Renderer::finish(const Frame& frame)
+{
+	// Nothing pushed after it can replace it before it is drawn
+	m_queue.push(frame);
+	wake();
+}
+
+void Renderer::wake()
+{
+	m_signal.fetch_add(1, memory_order_release);
+	m_signal.notify_one();
+}
+
+void Renderer::run()
+{
+	Frame frame;
+	for (;;)
+	{
+		unsigned int seen = m_signal.load(memory_order_acquire);
+		int skipped = m_queue.popLatest(frame);
+		if (skipped >= 0)
+		{
+			m_dropped.fetch_add(skipped, memory_order_relaxed);
+			if (m_clear)
+				clearScreen();
+			frame.draw(m_out);
+			m_out.flush();
+		}
+		else if (m_stopping.load())
+			return;
+		else
+			m_signal.wait(seen, memory_order_acquire);
+	}
+}
@@ -0,0 +1,66 @@
+#ifndef RENDERER_H
+
+#define RENDERER_H
+
+#include <atomic>
+#include <thread>
+#include <iosfwd>
+#include "Frame.h"
+
+// Single-producer/single-consumer hand-off of the newest frame, as a
+// triple buffer: the producer fills its own slot and swaps it with the
+// middle one, and the consumer swaps the middle slot for its own only
+// when a newer frame is there.  Neither side ever waits, and a frame
+// the consumer hasn't taken yet is replaced by the next one.
+class FrameQueue
+{
+public:
+	// Constructor
+	FrameQueue();
+
+	// Mutators
+	void push(const Frame& frame);         // producer
+	int  popLatest(Frame& frame);          // consumer; number of frames skipped, or -1 if none is new
+
+private:
+	static const unsigned int FRESH = 4;   // set in m_middle when it holds an untaken frame
+
+	Frame              m_frames[3];
+	unsigned long long m_sequence[3];      // number of the frame in each slot
+	unsigned int       m_back;             // producer's slot
+	unsigned long long m_pushed;           // producer's count of frames pushed
+	alignas(64) std::atomic<unsigned int> m_middle;  // slot between the two, plus FRESH
+	alignas(64) unsigned int       m_front;          // consumer's slot
+	unsigned long long m_taken;            // number of the frame last taken
+};
+
+// Draws frames on its own thread so a slow terminal never holds up the
+// simulation.  show() only copies the frame into the queue.
+class Renderer
+{
+public:
+	// Constructor/destructor
+	Renderer(std::ostream& out, bool clear);
+	~Renderer();
+
+	// Accessors
+	long framesDropped() const;
+
+	// Mutators
+	void show(const Frame& frame);    // never blocks; replaced if a newer frame comes first
+	void finish(const Frame& frame);  // the last frame, so it is drawn
+
+private:
+	std::ostream&     m_out;
+	bool              m_clear;  // clear the screen before each frame
+	FrameQueue        m_queue;
+	std::atomic<unsigned int> m_signal;  // bumped on each show, for wait/notify
+	std::atomic<bool> m_stopping;
+	std::atomic<long> m_dropped;
+	std::thread       m_thread;
+
+	void run();
+	void wake();
+};
+
+#endif
@@ -0,0 +1,356 @@
+#include "Server.h"
+#include "Game.h"
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+using namespace std;
+
+// One connected client.  Sessions have no thread of their own; they are
+// just this state plus the Game's session coroutine, suspended at its
+// prompt and resumed by whichever worker accepted them.
+struct GameServer::Session
+{
+	int    fd;
+	Game*  game;
+	GameTask* task;    // game->session, suspended at its prompt
+	ostringstream screen;  // what the session has written since last read
+	string in;         // bytes received but not yet a full line
+	string out;        // reply bytes not yet written
+	size_t sent;       // how much of out has been written
+	unsigned int events;  // what epoll watches the socket for (see watch)
+	bool   closing;    // game over or EOF; close once out is flushed
+	unsigned long      requests;
+	unsigned long long totalNs;
+	unsigned long long maxNs;
+};
+
+// A worker owns an epoll set and the sessions it accepted.  Every worker
+// waits on the shared listening socket with EPOLLEXCLUSIVE, so the
+// kernel spreads new connections across workers.
+struct GameServer::Worker
+{
+	int  epollFd;
+	long nSessions;
+};
+
+namespace
+{
+	const char* PROMPT = "Move (u/d/l/r//h/q): \n";
+	const size_t MAXLINE = 1024;  // longest line a client may send
+	const size_t MAXPENDING = 64 * 1024;  // reply bytes held for a client that isn't reading
+}
+
+GameServer::GameServer(string address, int nWorkers, int rows, int cols, int nSnakes)
+{
+	if (nWorkers < 1)
+	{
+		cout << "***** GameServer needs at least one worker thread!" << endl;
+		exit(1);
+	}
+	m_address = address;
+	m_nWorkers = nWorkers;
+	m_rows = rows;
+	m_cols = cols;
+	m_nSnakes = nSnakes;
+	m_listenFd = -1;
+}
+
+GameServer::~GameServer()
+{
+	if (m_listenFd >= 0)
+		::close(m_listenFd);
+}
+
+bool GameServer::run()
+{
+	if (!openListener())
+		return false;
+	vector<Worker> workers(m_nWorkers);
+	for (int k = 0; k < m_nWorkers; k++)
+	{
+		workers[k].nSessions = 0;
+		workers[k].epollFd = epoll_create1(EPOLL_CLOEXEC);
+		if (workers[k].epollFd < 0)
+		{
+			for (int j = 0; j < k; j++)
+				::close(workers[j].epollFd);
+			return false;
+		}
+	}
+	cout << "Serving games on " << m_address << " with " << m_nWorkers
+		<< " worker threads." << endl;
+
+	vector<thread> threads;
+	for (int k = 0; k < m_nWorkers; k++)
+		threads.push_back(thread(&GameServer::serve, this, ref(workers[k])));
+	for (size_t k = 0; k < threads.size(); k++)
+		threads[k].join();
+	return true;
+}
+
+bool GameServer::openListener()
+{
+	// An address made only of digits is a localhost TCP port; anything
+	// else is the path of a Unix domain socket
+	bool isPort = !m_address.empty() &&
+		m_address.find_first_not_of("0123456789") == string::npos;
+	if (isPort)
+	{
+		m_listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		if (m_listenFd < 0)
+			return false;
+		int on = 1;
+		setsockopt(m_listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+		sockaddr_in addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_port = htons(static_cast<uint16_t>(atoi(m_address.c_str())));
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		if (bind(m_listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+			return false;
+	}
+	else
+	{
+		sockaddr_un addr;
+		memset(&addr, 0, sizeof(addr));
+		if (m_address.size() >= sizeof(addr.sun_path))
+			return false;
+		m_listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		if (m_listenFd < 0)
+			return false;
+		addr.sun_family = AF_UNIX;
+		strcpy(addr.sun_path, m_address.c_str());
+		unlink(m_address.c_str());
+		if (bind(m_listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+			return false;
+	}
+	return ::listen(m_listenFd, SOMAXCONN) == 0;
+}
+
+void GameServer::serve(Worker& w)
+{
+	epoll_event ev;
+	ev.events = EPOLLIN | EPOLLEXCLUSIVE;
+	ev.data.ptr = nullptr;  // the listening socket
+	epoll_ctl(w.epollFd, EPOLL_CTL_ADD, m_listenFd, &ev);
+
+	const int MAXEVENTS = 256;
+	epoll_event events[MAXEVENTS];
+	for (;;)
+	{
+		int n = epoll_wait(w.epollFd, events, MAXEVENTS, -1);
+		for (int k = 0; k < n; k++)
+		{
+			Session* s = static_cast<Session*>(events[k].data.ptr);
+			if (s == nullptr)
+				acceptSessions(w);
+			else if (events[k].events & (EPOLLIN | EPOLLHUP | EPOLLERR | EPOLLRDHUP))
+				onReadable(w, s);
+			else if (events[k].events & EPOLLOUT)
+			{
+				if (!flush(w, s) || (s->closing && s->out.empty()))
+					endSession(w, s);
+				else if (s->out.empty())
+					onReadable(w, s);  // the lines held back while it was full
+			}
+		}
+	}
+}
+
+void GameServer::acceptSessions(Worker& w)
+{
+	for (;;)
+	{
+		int fd = accept4(m_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd < 0)
+			return;  // EAGAIN: another worker took it, or none left
+
+		Session* s = new Session;
+		s->fd = fd;
+		s->game = new Game(m_rows, m_cols, m_nSnakes);
+		s->task = new GameTask(s->game->session(s->screen));
+		s->sent = 0;
+		s->events = EPOLLIN | EPOLLRDHUP;
+		s->closing = false;
+		s->requests = 0;
+		s->totalNs = 0;
+		s->maxNs = 0;
+
+		s->out = s->screen.str();  // the pit and the first prompt
+		s->screen.str("");
+
+		epoll_event ev;
+		ev.events = s->events;
+		ev.data.ptr = s;
+		epoll_ctl(w.epollFd, EPOLL_CTL_ADD, fd, &ev);
+		w.nSessions++;
+		if (!flush(w, s))
+			endSession(w, s);
+	}
+}
+
+void GameServer::onReadable(Worker& w, Session* s)
+{
+	// Handle each complete line as soon as it is read, but only while
+	// fewer than MAXPENDING reply bytes are waiting to go out; past that
+	// the rest wait in s->in, and nothing more is read, until the client
+	// takes its replies.  At EOF the lines already received still get
+	// their replies before the session closes.
+	char buf[4096];
+	for (;;)
+	{
+		size_t start = 0;
+		size_t end;
+		while (!s->closing && s->out.size() - s->sent < MAXPENDING &&
+			(end = s->in.find('\n', start)) != string::npos)
+		{
+			handleLine(s, s->in.substr(start, end - start));
+			start = end + 1;
+		}
+		s->in.erase(0, start);
+		if (s->closing)
+			break;
+		if (s->out.size() - s->sent >= MAXPENDING)
+		{
+			if (!flush(w, s))
+			{
+				endSession(w, s);
+				return;
+			}
+			if (!s->out.empty())
+				return;  // serve calls this again once it drains
+			continue;
+		}
+		if (s->in.size() > MAXLINE)
+		{
+			endSession(w, s);  // no sensible client sends that much
+			return;
+		}
+
+		ssize_t n = read(s->fd, buf, sizeof(buf));
+		if (n > 0)
+			s->in.append(buf, n);
+		else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		else if (n < 0)
+		{
+			endSession(w, s);  // error
+			return;
+		}
+		else
+			s->closing = true;  // EOF
+	}
+
+	if (!flush(w, s) || (s->closing && s->out.empty()))
+		endSession(w, s);
+}
+
+void GameServer::handleLine(Session* s, const string& line)
+{
+	auto start = chrono::steady_clock::now();
+
+	string action = line;
+	if (!action.empty() && action[action.size() - 1] == '\r')
+		action.erase(action.size() - 1);
+
+	ostringstream reply;
+	if (action == "s")
+	{
+		size_t bytes = sizeof(Session) + s->in.capacity() + s->out.capacity() +
+			s->game->memoryUsage();
+		reply << "Session memory: " << bytes << " bytes; requests: " << s->requests
+			<< "; mean latency: " << (s->requests > 0 ? s->totalNs / s->requests : 0)
+			<< " ns; max latency: " << s->maxNs << " ns" << endl;
+		reply << PROMPT;
+	}
+	else
+	{
+		s->task->resume(action);
+		reply << s->screen.str();
+		s->screen.str("");
+		if (s->task->done())
+		{
+			s->closing = true;
+			if (action.size() > 0 && action[0] == 'q')
+				reply << "Goodbye." << endl;
+			else
+				reply << "Game over." << endl;
+		}
+	}
+	s->out += reply.str();
+
+	unsigned long long ns = chrono::duration_cast<chrono::nanoseconds>(
+		chrono::steady_clock::now() - start).count();
+	s->requests++;
+	s->totalNs += ns;
+	if (ns > s->maxNs)
+		s->maxNs = ns;
+}
+
+bool GameServer::flush(Worker& w, Session* s)
+{
+	// Write as much of the pending reply as the socket takes; if it
+	// fills up, wait for EPOLLOUT.  Returns false if the client is gone.
+	while (s->sent < s->out.size())
+	{
+		ssize_t n = send(s->fd, s->out.data() + s->sent, s->out.size() - s->sent, MSG_NOSIGNAL);
+		if (n < 0)
+		{
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+				return false;
+			break;
+		}
+		s->sent += n;
+	}
+	if (s->sent == s->out.size())
+	{
+		s->out.clear();
+		s->sent = 0;
+	}
+	watch(w, s);
+	return true;
+}
+
+void GameServer::watch(Worker& w, Session* s)
+{
+	// Watch for input only while few reply bytes are waiting, so a
+	// client that sends without reading can't make them pile up, and
+	// never once the session is closing, or EOF would wake us over and
+	// over; watch for output only while there is some
+	size_t pending = s->out.size() - s->sent;
+	unsigned int events = 0;
+	if (!s->closing && pending < MAXPENDING)
+		events |= EPOLLIN | EPOLLRDHUP;
+	if (pending > 0)
+		events |= EPOLLOUT;
+	if (events != s->events)
+	{
+		epoll_event ev;
+		ev.events = events;
+		ev.data.ptr = s;
+		epoll_ctl(w.epollFd, EPOLL_CTL_MOD, s->fd, &ev);
+		s->events = events;
+	}
+}
+
+void GameServer::endSession(Worker& w, Session* s)
+{
+	epoll_ctl(w.epollFd, EPOLL_CTL_DEL, s->fd, nullptr);
+	::close(s->fd);
+	delete s->task;  // before the game its coroutine plays
+	delete s->game;
+	delete s;
+	w.nSessions--;
+}
@@ -0,0 +1,45 @@
+#ifndef SERVER_H
+
+#define SERVER_H
+
+#include <string>
+
+class Game;
+
+// Hosts many games in one process.  Clients connect over a Unix domain
+// socket (or localhost TCP if the address is a port number) and send the
+// same one-line commands Game::play reads from the keyboard; each reply
+// is the rendered pit followed by the move prompt.  The extra command
+// 's' reports the session's memory use and request latency.
+class GameServer
+{
+public:
+	// Constructor/destructor
+	GameServer(std::string address, int nWorkers, int rows, int cols, int nSnakes);
+	~GameServer();
+
+	// Mutators
+	bool run();  // serves until the process is killed; false if it can't start
+
+private:
+	struct Session;
+	struct Worker;
+
+	std::string m_address;
+	int  m_nWorkers;
+	int  m_rows;
+	int  m_cols;
+	int  m_nSnakes;
+	int  m_listenFd;
+
+	bool openListener();
+	void serve(Worker& w);
+	void acceptSessions(Worker& w);
+	void onReadable(Worker& w, Session* s);
+	void handleLine(Session* s, const std::string& line);
+	bool flush(Worker& w, Session* s);
+	void watch(Worker& w, Session* s);
+	void endSession(Worker& w, Session* s);
+};
+
+#endif
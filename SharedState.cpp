@@ -0,0 +1,149 @@
+#include "SharedState.h"
+#include "Pit.h"
+#include "Player.h"
+#include <iostream>
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+using namespace std;
+
+namespace
+{
+	// A reader gives up on a frame after this many tries, yielding
+	// between them: a publisher that died mid-write leaves the
+	// sequence odd for good
+	const int MAXREADTRIES = 1000;
+}
+
+struct SharedState::Segment
+{
+	atomic<unsigned int> seq;  // odd while the publisher is writing
+	SharedFrame frame;
+};
+
+SharedState::SharedState(string name, bool publisher)
+{
+	// Segment names must start with '/'
+	m_name = (name.size() > 0 && name[0] == '/' ? name : "/" + name);
+	m_publisher = publisher;
+	m_segment = nullptr;
+	m_turn = 0;
+
+	int fd = shm_open(m_name.c_str(), publisher ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+	if (fd < 0)
+		return;
+	if (publisher && ftruncate(fd, sizeof(Segment)) < 0)
+	{
+		close(fd);
+		return;
+	}
+
+	// A reader must not map past the end of a segment that is shorter
+	// than ours (not yet sized, or another build's): touching that
+	// memory would raise SIGBUS
+	struct stat st;
+	if (fstat(fd, &st) < 0 || st.st_size < static_cast<off_t>(sizeof(Segment)))
+	{
+		close(fd);
+		return;
+	}
+	void* p = mmap(nullptr, sizeof(Segment), publisher ? PROT_READ | PROT_WRITE : PROT_READ,
+		MAP_SHARED, fd, 0);
+	close(fd);
+	if (p == MAP_FAILED)
+		return;
+	m_segment = static_cast<Segment*>(p);
+	if (publisher)
+	{
+		m_segment->seq.store(0, memory_order_relaxed);
+		m_segment->frame.rows = 0;
+	}
+}
+
+SharedState::~SharedState()
+{
+	if (m_segment != nullptr)
+		munmap(m_segment, sizeof(Segment));
+	if (m_publisher)
+		shm_unlink(m_name.c_str());
+}
+
+bool SharedState::isOpen() const
+{
+	return m_segment != nullptr;
+}
+
+void SharedState::publish(const Pit& pit)
+{
+	if (m_segment == nullptr || !m_publisher)
+		return;
+	unsigned int seq = m_segment->seq.load(memory_order_relaxed);
+	m_segment->seq.store(seq + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+
+	SharedFrame& f = m_segment->frame;
+	m_turn++;
+	f.rows = pit.rows();
+	f.cols = pit.cols();
+	f.turn = m_turn;
+	f.nSnakes = pit.snakeCount();
+	const Player* p = pit.player();
+	f.playerAge = (p != nullptr ? p->age() : 0);
+	f.playerDead = (p != nullptr && p->isDead());
+	pit.exportObservation(&f.planes[0][0], MAXROWS * MAXCOLS, pit.cols());
+
+	m_segment->seq.store(seq + 2, memory_order_release);
+}
+
+bool SharedState::read(SharedFrame& frame) const
+{
+	// Returns false if nothing has been published yet, or if no whole
+	// frame could be copied within MAXREADTRIES tries
+	if (m_segment == nullptr)
+		return false;
+	for (int tries = 0; tries < MAXREADTRIES; tries++)
+	{
+		if (tries > 0)
+			sched_yield();
+		unsigned int before = m_segment->seq.load(memory_order_acquire);
+		if (before % 2 == 1)
+			continue;  // publisher is mid-write
+		memcpy(&frame, &m_segment->frame, sizeof(SharedFrame));
+		atomic_thread_fence(memory_order_acquire);
+		if (m_segment->seq.load(memory_order_relaxed) == before)
+			return before > 0 && frame.rows > 0 && frame.rows <= MAXROWS &&
+				frame.cols > 0 && frame.cols <= MAXCOLS;
+	}
+	return false;
+}
+
+void SharedFrame::render(ostream& out) const
+{
+	for (int r = 0; r < rows; r++)
+	{
+		for (int c = 0; c < cols; c++)
+		{
+			int k = r * cols + c;
+			int n = planes[OBS_SNAKES][k];
+			char gridChar = '.';
+			if (n == 1)
+				gridChar = 'S';
+			else if (n > 1)
+				gridChar = (n < 9 ? '0' + n : '9');
+			if (planes[OBS_PLAYERS][k] > 0)
+				gridChar = '@';
+			out << gridChar;
+		}
+		out << endl;
+	}
+	out << endl;
+	out << "Turn " << turn << ": there are " << nSnakes << " snakes remaining." << endl;
+	if (playerAge > 0)
+		out << "The player has lasted " << playerAge << " steps." << endl;
+	if (playerDead)
+		out << "The player is dead." << endl;
+}
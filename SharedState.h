@@ -0,0 +1,57 @@
+#ifndef SHAREDSTATE_H
+
+#define SHAREDSTATE_H
+
+#include <string>
+#include <iosfwd>
+#include "globals.h"
+
+class Pit;
+
+// One published frame of a pit, as laid out in shared memory (minus the
+// sequence counter that guards it)
+struct SharedFrame
+{
+	int  rows;
+	int  cols;
+	int  turn;       // how many frames have been published
+	int  nSnakes;
+	int  playerAge;  // of the first player
+	int  playerDead;
+	unsigned char planes[NUMOBSPLANES][MAXROWS * MAXCOLS];  // see Pit::exportObservation
+
+	void render(std::ostream& out) const;
+};
+
+// A POSIX shared-memory segment holding the latest SharedFrame of a
+// running game.  The game publishes after each moveSnakes under a
+// seqlock: it never waits for readers, and any number of reader
+// processes retry until they copy a frame that wasn't being written,
+// giving up after a bounded number of tries.
+class SharedState
+{
+public:
+	// Constructor/destructor
+	SharedState(std::string name, bool publisher);
+	~SharedState();
+
+	// Accessors
+	bool isOpen() const;
+	bool read(SharedFrame& frame) const;
+
+	// Mutators
+	void publish(const Pit& pit);
+
+private:
+	struct Segment;
+
+	std::string m_name;
+	bool        m_publisher;
+	Segment*    m_segment;
+	int         m_turn;
+
+	SharedState(const SharedState&) = delete;
+	SharedState& operator=(const SharedState&) = delete;
+};
+
+#endif
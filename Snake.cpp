@@ -1,45 +1,84 @@
-#include "Snake.h"
-#include "Pit.h"
-#include "globals.h"
-#include <iostream>
-using namespace std;
-
-Snake::Snake(Pit* pp, int r, int c)
-{
-	if (pp == nullptr)
-	{
-		cout << "***** A snake must be in some Pit!" << endl;
-		exit(1);
-	}
-	if (r < 1 || r > pp->rows() || c < 1 || c > pp->cols())
-	{
-		cout << "***** Snake created with invalid coordinates (" << r << ","
-			<< c << ")!" << endl;
-		exit(1);
-	}
-	m_pit = pp;
-	m_row = r;
-	m_col = c;
-}
-
-int Snake::row() const
-{
-	return m_row;
-}
-
-int Snake::col() const
-{
-	return m_col;
-}
-
-void Snake::move()
-{
-	// Attempt to move in a random direction; if we can't move, don't move
-	switch (rand() % 4)
-	{
-	case UP:     if (m_row > 1)             m_row--; break;
-	case DOWN:   if (m_row < m_pit->rows()) m_row++; break;
-	case LEFT:   if (m_col > 1)             m_col--; break;
-	case RIGHT:  if (m_col < m_pit->cols()) m_col++; break;
-	}
+#include "Snake.h"
+#include "Pit.h"
+#include "globals.h"
+#include <iostream>
+using namespace std;
+
+Snake::Snake(Pit* pp, int r, int c)
+{
+	if (pp == nullptr)
+	{
+		cout << "***** A snake must be in some Pit!" << endl;
+		exit(1);
+	}
+	if (r < 1 || r > pp->rows() || c < 1 || c > pp->cols())
+	{
+		cout << "***** Snake created with invalid coordinates (" << r << ","
+			<< c << ")!" << endl;
+		exit(1);
+	}
+	m_pit = pp;
+	m_row = r;
+	m_col = c;
+}
+
+int Snake::row() const
+{
+	return m_row;
+}
+
+int Snake::col() const
+{
+	return m_col;
+}
+
+void Snake::moveTo(int r, int c)
+{
+	// For the pit, which may work out a snake's moves itself (see
+	// Pit::advance); the caller keeps its bookkeeping in step
+	m_row = r;
+	m_col = c;
+}
+
+void Snake::move()
+{
+	int distance = (m_pit->isHunting() ? m_pit->distanceToPlayer(m_row, m_col) : -1);
+	if (distance >= 0)
+	{
+		// Step to a neighbor closer to the nearest player, choosing at
+		// random when more than one is.  A snake already on a player's
+		// cell has no closer neighbor, so it stays put.
+		static const int dirs[4] = { UP, DOWN, LEFT, RIGHT };
+		int closer[4];
+		int nCloser = 0;
+		for (int d = 0; d < 4; d++)
+		{
+			int rowDelta;
+			int colDelta;
+			directionToDeltas(dirs[d], rowDelta, colDelta);
+			int nd = m_pit->distanceToPlayer(m_row + rowDelta, m_col + colDelta);
+			if (nd >= 0 && nd < distance &&
+				m_row + rowDelta >= 1 && m_row + rowDelta <= m_pit->rows() &&
+				m_col + colDelta >= 1 && m_col + colDelta <= m_pit->cols())
+				closer[nCloser++] = dirs[d];
+		}
+		if (nCloser > 0)
+		{
+			int rowDelta;
+			int colDelta;
+			directionToDeltas(closer[nCloser == 1 ? 0 : m_pit->randInt(nCloser)], rowDelta, colDelta);
+			m_row += rowDelta;
+			m_col += colDelta;
+		}
+		return;
+	}
+
+	// Attempt to move in a random direction; if we can't move, don't move
+	switch (m_pit->randInt(4))
+	{
+	case UP:     if (m_row > 1)             m_row--; break;
+	case DOWN:   if (m_row < m_pit->rows()) m_row++; break;
+	case LEFT:   if (m_col > 1)             m_col--; break;
+	case RIGHT:  if (m_col < m_pit->cols()) m_col++; break;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,239 @@
+#include "Snapshot.h"
+#include "Pit.h"
+#include "Player.h"
+#include "Snake.h"
+#include "globals.h"
+#include <vector>
+#include <cstring>
+#include <bit>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+using namespace std;
+
+// The records are written straight from memory, which is only the
+// promised little-endian layout on a little-endian machine
+static_assert(endian::native == endian::little, "snapshots assume a little-endian host");
+static_assert(sizeof(SnapshotHeader) == 72 && sizeof(SnapshotPlayer) == 16 &&
+	sizeof(SnapshotSnake) == 4, "snapshot records must have no padding");
+
+namespace
+{
+	const char MAGIC[8] = { 'S', 'N', 'A', 'K', 'E', 'P', 'I', 'T' };
+
+	const uint64_t FNVBASIS = 14695981039346656037ULL;
+
+	uint64_t fnv1a(const unsigned char* p, size_t n, uint64_t h)
+	{
+		for (size_t k = 0; k < n; k++)
+		{
+			h ^= p[k];
+			h *= 1099511628211ULL;
+		}
+		return h;
+	}
+
+	uint64_t checksum(const SnapshotHeader& header, const unsigned char* payload)
+	{
+		// Covers the header, with its checksum taken as 0, and the payload
+		SnapshotHeader h = header;
+		h.checksum = 0;
+		uint64_t sum = fnv1a(reinterpret_cast<const unsigned char*>(&h), sizeof(h), FNVBASIS);
+		return fnv1a(payload, header.payloadSize, sum);
+	}
+
+	size_t payloadSize(size_t nPlayers, size_t cells, size_t nSnakes)
+	{
+		return nPlayers * sizeof(SnapshotPlayer) + cells + nSnakes * sizeof(SnapshotSnake);
+	}
+
+	bool writeAll(int fd, const unsigned char* p, size_t n)
+	{
+		while (n > 0)
+		{
+			ssize_t written = write(fd, p, n);
+			if (written <= 0)
+				return false;
+			p += written;
+			n -= written;
+		}
+		return true;
+	}
+}
+
+bool Snapshot::save(const Pit& pit, const string& path)
+{
+	int nPlayers = pit.playerCount();
+	int nSnakes = pit.snakeCount();
+	int cells = pit.rows() * pit.cols();
+	vector<unsigned char> buffer(sizeof(SnapshotHeader) + payloadSize(nPlayers, cells, nSnakes));
+
+	SnapshotHeader header;
+	memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = SNAPSHOTVERSION;
+	header.headerSize = sizeof(SnapshotHeader);
+	header.rows = pit.rows();
+	header.cols = pit.cols();
+	header.nPlayers = nPlayers;
+	header.nSnakes = nSnakes;
+	header.hunting = pit.isHunting();
+	header.turn = pit.m_turn;
+	header.resortInterval = pit.m_resortInterval;
+	header.turnsSinceResort = pit.m_turnsSinceResort;
+	header.rng = pit.m_rng;
+	header.payloadSize = buffer.size() - sizeof(SnapshotHeader);
+
+	unsigned char* payload = buffer.data() + sizeof(SnapshotHeader);
+	SnapshotPlayer* players = reinterpret_cast<SnapshotPlayer*>(payload);
+	for (int k = 0; k < nPlayers; k++)
+	{
+		const Player* pp = pit.player(k);
+		players[k].row = pp->row();
+		players[k].col = pp->col();
+		players[k].age = pp->age();
+		players[k].dead = pp->isDead();
+	}
+	unsigned char* history = payload + nPlayers * sizeof(SnapshotPlayer);
+	pit.history().exportCounts(history);
+	SnapshotSnake* snakes = reinterpret_cast<SnapshotSnake*>(history + cells);
+	for (int k = 0; k < nSnakes; k++)
+	{
+		snakes[k].row = static_cast<uint8_t>(pit.m_snakes[k].row());
+		snakes[k].col = static_cast<uint8_t>(pit.m_snakes[k].col());
+		snakes[k].nextAtCell = pit.m_nextAtCell[k];
+	}
+	header.checksum = checksum(header, payload);
+	memcpy(buffer.data(), &header, sizeof(header));
+
+	// Write a new file and rename it over the old one, so a crash
+	// mid-save never leaves a torn snapshot behind
+	string temp = path + ".tmp";
+	int fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		return false;
+	bool ok = writeAll(fd, buffer.data(), buffer.size());
+	ok = (close(fd) == 0) && ok;
+	if (!ok || rename(temp.c_str(), path.c_str()) != 0)
+	{
+		unlink(temp.c_str());
+		return false;
+	}
+	return true;
+}
+
+Pit* Snapshot::load(const string& path)
+{
+	// Returns a new pit, or nullptr if the file can't be read or isn't a
+	// valid snapshot of this version
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return nullptr;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SnapshotHeader))
+	{
+		close(fd);
+		return nullptr;
+	}
+	size_t size = st.st_size;
+	void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mapped == MAP_FAILED)
+		return nullptr;
+	const unsigned char* base = static_cast<const unsigned char*>(mapped);
+	const SnapshotHeader& header = *reinterpret_cast<const SnapshotHeader*>(base);
+	const unsigned char* payload = base + sizeof(SnapshotHeader);
+
+	// Check the header, then that the payload is all there and intact
+	bool ok = memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+		header.version == SNAPSHOTVERSION &&
+		header.headerSize == sizeof(SnapshotHeader) &&
+		header.rows >= 1 && header.rows <= MAXROWS &&
+		header.cols >= 1 && header.cols <= MAXCOLS &&
+		header.nPlayers <= MAXPLAYERS && header.nSnakes <= MAXSNAKES &&
+		header.hunting <= 1 && header.turn >= 0 &&
+		header.resortInterval >= 0 && header.turnsSinceResort >= 0 &&
+		header.rng != 0 &&
+		header.payloadSize == payloadSize(header.nPlayers, header.rows * header.cols, header.nSnakes) &&
+		header.payloadSize == size - sizeof(SnapshotHeader) &&
+		header.checksum == checksum(header, payload);
+
+	int rows = header.rows;
+	int cols = header.cols;
+	int nPlayers = header.nPlayers;
+	int nSnakes = header.nSnakes;
+	const SnapshotPlayer* players = reinterpret_cast<const SnapshotPlayer*>(payload);
+	const unsigned char* history = payload + nPlayers * sizeof(SnapshotPlayer);
+	const SnapshotSnake* snakes = reinterpret_cast<const SnapshotSnake*>(history + rows * cols);
+
+	// Every record must be in range, and each cell's list must chain
+	// together exactly the snakes in that cell, once each
+	for (int k = 0; ok && k < nPlayers; k++)
+		ok = players[k].row >= 1 && players[k].row <= rows &&
+			players[k].col >= 1 && players[k].col <= cols &&
+			players[k].age >= 0 && (players[k].dead == 0 || players[k].dead == 1);
+	int pointedAt[MAXSNAKES] = {};
+	for (int k = 0; ok && k < nSnakes; k++)
+	{
+		int next = snakes[k].nextAtCell;
+		ok = snakes[k].row >= 1 && snakes[k].row <= rows &&
+			snakes[k].col >= 1 && snakes[k].col <= cols &&
+			next >= -1 && next < nSnakes;
+		if (ok && next >= 0)
+			ok = ++pointedAt[next] == 1 &&
+				snakes[next].row == snakes[k].row && snakes[next].col == snakes[k].col;
+	}
+	bool hasHead[MAXROWS][MAXCOLS] = {};
+	int chained = 0;
+	for (int k = 0; ok && k < nSnakes; k++)
+	{
+		if (pointedAt[k] != 0)
+			continue;
+		bool& seen = hasHead[snakes[k].row - 1][snakes[k].col - 1];
+		ok = !seen;
+		seen = true;
+		for (int s = k; s >= 0 && chained <= nSnakes; s = snakes[s].nextAtCell)
+			chained++;
+	}
+	ok = ok && chained == nSnakes;
+
+	Pit* pit = nullptr;
+	if (ok)
+	{
+		pit = new Pit(rows, cols);
+		pit->setHunting(header.hunting != 0);
+		for (int k = 0; k < nPlayers; k++)
+		{
+			pit->addPlayer(players[k].row, players[k].col);
+			pit->player(k)->restore(players[k].row, players[k].col, players[k].age, players[k].dead != 0);
+		}
+		pit->history().importCounts(history);
+		pit->m_snakes.reserve(nSnakes);
+		for (int k = 0; k < nSnakes; k++)
+			pit->addSnake(snakes[k].row, snakes[k].col);
+
+		// addSnake built cell lists of its own; put back the saved ones,
+		// which decide which snake a kill removes
+		for (int r = 0; r < rows; r++)
+			for (int c = 0; c < cols; c++)
+				pit->m_firstAtCell[r][c] = -1;
+		for (int k = 0; k < nSnakes; k++)
+		{
+			pit->m_nextAtCell[k] = snakes[k].nextAtCell;
+			pit->m_prevAtCell[k] = -1;
+		}
+		for (int k = 0; k < nSnakes; k++)
+		{
+			if (snakes[k].nextAtCell >= 0)
+				pit->m_prevAtCell[snakes[k].nextAtCell] = static_cast<short>(k);
+			if (pointedAt[k] == 0)
+				pit->m_firstAtCell[snakes[k].row - 1][snakes[k].col - 1] = static_cast<short>(k);
+		}
+		pit->m_turn = header.turn;
+		pit->m_resortInterval = header.resortInterval;
+		pit->m_turnsSinceResort = header.turnsSinceResort;
+		pit->m_rng = header.rng;
+	}
+	munmap(mapped, size);
+	return pit;
+}
@@ -0,0 +1,64 @@
+#ifndef SNAPSHOT_H
+
+#define SNAPSHOT_H
+
+#include <string>
+#include <cstdint>
+
+class Pit;
+
+const std::uint32_t SNAPSHOTVERSION = 1;
+
+// The fixed-size start of a snapshot file.  Every field is
+// little-endian; the payload that follows is, in order,
+//     nPlayers SnapshotPlayers
+//     rows*cols bytes of History counts, row by row
+//     nSnakes SnapshotSnakes, in the pit's storage order
+// and checksum is the FNV-1a hash of the header (with checksum taken
+// as 0) followed by those payloadSize bytes.
+struct SnapshotHeader
+{
+	char          magic[8];      // "SNAKEPIT"
+	std::uint32_t version;       // SNAPSHOTVERSION
+	std::uint32_t headerSize;    // sizeof(SnapshotHeader)
+	std::uint32_t rows;
+	std::uint32_t cols;
+	std::uint32_t nPlayers;
+	std::uint32_t nSnakes;
+	std::uint32_t hunting;
+	std::int32_t  turn;
+	std::int32_t  resortInterval;
+	std::int32_t  turnsSinceResort;
+	std::uint64_t rng;           // generator state
+	std::uint64_t payloadSize;
+	std::uint64_t checksum;
+};
+
+struct SnapshotPlayer
+{
+	std::int32_t row;
+	std::int32_t col;
+	std::int32_t age;
+	std::int32_t dead;
+};
+
+struct SnapshotSnake
+{
+	std::uint8_t row;
+	std::uint8_t col;
+	std::int16_t nextAtCell;  // the snake after this one in its cell's list, or -1
+};
+
+// Saves a pit's complete state (players, snakes, kill history,
+// generator and turn counter) to a binary file, and makes a new pit
+// from one.  The records are stored exactly as they sit in memory, so
+// loading maps the file and checks it rather than parsing it.  The
+// pit's analytics and spectators are not part of its state.
+class Snapshot
+{
+public:
+	static bool save(const Pit& pit, const std::string& path);
+	static Pit* load(const std::string& path);
+};
+
+#endif
@@ -1,22 +1,29 @@
-#ifndef GLOBALS_H
-
-#define GLOBALS_H
-
-const int MAXROWS = 20;             // max number of rows in the pit
-const int MAXCOLS = 40;             // max number of columns in the pit
-const int MAXSNAKES = 180;          // max number of snakes allowed
-
-const int UP = 0;
-const int DOWN = 1;
-const int LEFT = 2;
-const int RIGHT = 3;
-
-///////////////////////////////////////////////////////////////////////////
-//  Auxiliary function declarations
-///////////////////////////////////////////////////////////////////////////
-
-int decodeDirection(char dir);
-bool directionToDeltas(int dir, int& rowDelta, int& colDelta);
-void clearScreen();
-
+#ifndef GLOBALS_H
+
+#define GLOBALS_H
+
+const int MAXROWS = 20;             // max number of rows in the pit
+const int MAXCOLS = 40;             // max number of columns in the pit
+const int MAXSNAKES = 180;          // max number of snakes allowed
+const int MAXPLAYERS = MAXROWS * MAXCOLS;  // max number of players in a pit
+
+// Planes written by Pit::exportObservation
+const int OBS_SNAKES = 0;           // number of snakes in the cell
+const int OBS_PLAYERS = 1;          // number of live players in the cell
+const int OBS_KILLS = 2;            // History kill count for the cell
+const int NUMOBSPLANES = 3;
+
+const int UP = 0;
+const int DOWN = 1;
+const int LEFT = 2;
+const int RIGHT = 3;
+
+///////////////////////////////////////////////////////////////////////////
+//  Auxiliary function declarations
+///////////////////////////////////////////////////////////////////////////
+
+int decodeDirection(char dir);
+bool directionToDeltas(int dir, int& rowDelta, int& colDelta);
+void clearScreen();
+
 #endif
\ No newline at end of file
@@ -1,159 +1,443 @@
-#include <ctime>
-#include <cstdlib>
-#include "Game.h"
-using namespace std;
-
-int main()
-{
-	// Initialize the random number generator.  (You don't need to
-	// understand how this works.)
-	srand(static_cast<unsigned int>(time(0)));
-
-	// Create a game
-	// Use this instead to create a mini-game:   Game g(3, 3, 2);
-	Game g(9, 10, 15);
-
-	// Play the game
-	g.play();
-}
-
-
-/*
-#include "History.h"
-int main()
-{
-	History h;
-}
-*/
-
-/*#include "globals.h"
-#include "Snake.h"
-#include "Player.h"
-int main()
-{
-	Pit pt(10, 10);
-}
-*/
-
-/*
-#include "Player.h"
-#include "Pit.h"
-int main()
-{
-	Pit pt(10, 20);
-	Player p(&pt, 2, 3);
-	Snake s(&pt, 1, 1);
-}
-*/
-
-/*
-#include "Pit.h"
-#include "History.h"
-#include "Player.h"
-#include "globals.h"
-int main()
-{
-	Pit pt(3, 3);
-	pt.addPlayer(1, 1);
-	pt.addSnake(1, 2);
-	pt.addSnake(2, 2);
-	pt.addSnake(2, 3);
-	pt.player()->move(RIGHT);
-	pt.player()->move(LEFT);
-	pt.player()->move(DOWN);
-	pt.player()->move(RIGHT);
-	pt.player()->move(UP);
-	pt.history().display();
-}
-*/
-
-/*
-#include "Player.h"
-#include "Pit.h"
-int main()
-{
-	Pit pt(10, 20);
-	Player p(&pt, 2, 3);
-}
-*/
-
-/*
-#include "Pit.h"
-#include "Player.h"
-int main()
-{
-	Pit pt(10, 20);
-	Player p(&pt, 2, 3);
-}
-*/
-
-/*
-#include "globals.h"
-#include "Player.h"
-#include "Pit.h"
-int main()
-{
-	Pit pt(10, 20);
-	Player p(&pt, 2, 3);
-}
-*/
-
-/*
-#include "Pit.h"
-int main()
-{
-	Pit pt(10, 18);
-	pt.addPlayer(2, 2);
-}
-*/
-
-/*
-#include "Player.h"
-int main()
-{
-	Player p(nullptr, 1, 1);
-}
-*/
-
-/*
-#include "Snake.h"
-int main()
-{
-	Snake s(nullptr, 1, 1);
-}
-*/
-
-/*
-#include "History.h"
-int main()
-{
-	History h(2, 2);
-	for (int i = 0; i < 100; i++)
-		h.record(1, 1);
-	for (int i = 0; i < 3; i++)
-		h.record(1, 2);
-	for (int i = 0; i < 7; i++)
-		h.record(2, 1);
-	for (int i = 0; i < 18; i++)
-		h.record(2, 2);
-	h.display();
-}
-*/
-
-/*
-#include "Game.h"
-#include "Game.h"
-#include "Pit.h"
-#include "Pit.h"
-#include "History.h"
-#include "History.h"
-#include "Player.h"
-#include "Player.h"
-#include "Snake.h"
-#include "Snake.h"
-#include "globals.h"
-#include "globals.h"
-int main()
-{}
-*/
-
+#include <ctime>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <cctype>
+#include "Game.h"
+#include "Server.h"
+#include "SharedState.h"
+#include "Renderer.h"
+#include "FrameStream.h"
+#include "BatchRunner.h"
+#include "Benchmark.h"
+#include "Analytics.h"
+#include "Pit.h"
+#include "Player.h"
+#include "globals.h"
+#include <iostream>
+#include <string>
+#include <thread>
+#include <chrono>
+using namespace std;
+
+// Calls use with a new policy of the kind named (greedy, random or
+// search), started from seed; returns false for any other name
+template <typename Use>
+bool withPolicy(const char* name, unsigned long long seed, Use use)
+{
+	if (strcmp(name, "greedy") == 0)
+	{
+		GreedyPolicy policy;
+		policy.start(seed);
+		use(policy);
+	}
+	else if (strcmp(name, "random") == 0)
+	{
+		RandomPolicy policy;
+		policy.start(seed);
+		use(policy);
+	}
+	else if (strcmp(name, "search") == 0)
+	{
+		SearchPolicy policy;
+		policy.start(seed);
+		use(policy);
+	}
+	else
+		return false;
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	// Initialize the random number generator.  (You don't need to
+	// understand how this works.)
+	srand(static_cast<unsigned int>(time(0)));
+
+	// snakepit --bench [--seed <n>] [--turns <n>] [--resort <turns>]
+	// [<rows>x<cols>x<snakes> ...]: time whole games of each size,
+	// without and with rendering (and with the snakes resorted every so
+	// many turns, if asked), and write the results as JSON; with no
+	// sizes, a range from 3x3x2 to 20x40x180
+	if (argc >= 2 && strcmp(argv[1], "--bench") == 0)
+	{
+		unsigned long long seed = 1;
+		long minTurns = 100000;
+		int resortInterval = 0;
+		int k = 2;
+		for (; k + 1 < argc && argv[k][0] == '-'; k += 2)
+		{
+			if (strcmp(argv[k], "--seed") == 0)
+				seed = strtoull(argv[k + 1], nullptr, 10);
+			else if (strcmp(argv[k], "--turns") == 0)
+				minTurns = atol(argv[k + 1]);
+			else if (strcmp(argv[k], "--resort") == 0)
+				resortInterval = atoi(argv[k + 1]);
+			else
+				break;
+		}
+		Benchmark bench(seed, minTurns);
+		if (k == argc)
+			bench.addDefaultScenarios();
+		for (; k < argc; k++)
+		{
+			int rows, cols, nSnakes;
+			char extra;
+			if (sscanf(argv[k], "%dx%dx%d%c", &rows, &cols, &nSnakes, &extra) != 3 ||
+				!bench.addScenario(rows, cols, nSnakes, false) ||
+				!bench.addScenario(rows, cols, nSnakes, true) ||
+				(resortInterval > 0 && !bench.addScenario(rows, cols, nSnakes, false, resortInterval)))
+			{
+				cout << "***** " << argv[k] << " is not a valid <rows>x<cols>x<snakes> game!" << endl;
+				return 1;
+			}
+		}
+		return bench.run(cout) ? 0 : 1;
+	}
+
+	// snakepit --serve <socket path or port> [worker threads]
+	if (argc >= 3 && strcmp(argv[1], "--serve") == 0)
+	{
+		int nWorkers = (argc >= 4 ? atoi(argv[3]) : 4);
+		GameServer server(argv[2], nWorkers, 9, 10, 15);
+		return server.run() ? 0 : 1;
+	}
+
+	// snakepit --watch <name>: show the game another process publishes
+	if (argc >= 3 && strcmp(argv[1], "--watch") == 0)
+	{
+		SharedState state(argv[2], false);
+		if (!state.isOpen())
+		{
+			cout << "***** No game is being published as " << argv[2] << "!" << endl;
+			return 1;
+		}
+		SharedFrame frame;
+		int lastTurn = -1;
+		for (;;)
+		{
+			if (state.read(frame) && frame.turn != lastTurn)
+			{
+				clearScreen();
+				frame.render(cout);
+				lastTurn = frame.turn;
+			}
+			this_thread::sleep_for(chrono::milliseconds(50));
+		}
+	}
+
+	// snakepit --replay <file>: step through a game recorded with --record
+	if (argc >= 3 && strcmp(argv[1], "--replay") == 0)
+	{
+		FrameReader reader(argv[2]);
+		if (!reader.isOpen() || reader.frameCount() == 0)
+		{
+			cout << "***** " << argv[2] << " is not a recorded game!" << endl;
+			return 1;
+		}
+		Frame frame;
+		int n = 0;
+		for (;;)
+		{
+			if (!reader.read(n, frame))
+			{
+				cout << "***** Frame " << n + 1 << " of " << argv[2] << " is damaged!" << endl;
+				return 1;
+			}
+			clearScreen();
+			frame.draw(cout);
+			cout << "Frame " << n + 1 << " of " << reader.frameCount() << endl;
+			cout << "Enter: next, b: back, p: play to the end, <number>: go to frame, q: quit: ";
+			string command;
+			if (!getline(cin, command) || command == "q")
+				break;
+			if (command == "b")
+				n = (n > 0 ? n - 1 : 0);
+			else if (command == "p")
+			{
+				for (; n + 1 < reader.frameCount() && reader.read(n + 1, frame); n++)
+				{
+					clearScreen();
+					frame.draw(cout);
+					this_thread::sleep_for(chrono::milliseconds(100));
+				}
+			}
+			else if (!command.empty() && isdigit(static_cast<unsigned char>(command[0])))
+			{
+				int to = atoi(command.c_str());
+				n = (to < 1 ? 0 : (to > reader.frameCount() ? reader.frameCount() : to) - 1);
+			}
+			else if (n + 1 < reader.frameCount())
+				n++;
+		}
+		return 0;
+	}
+
+	// snakepit --survival <turns> [half-width] [greedy|random|search]:
+	// estimate how often the autoplayer lasts that many turns, to within
+	// the half-width
+	if (argc >= 3 && strcmp(argv[1], "--survival") == 0)
+	{
+		BatchRunner runner(9, 10, 15);
+		double halfWidth = (argc >= 4 ? atof(argv[3]) : 0.01);
+		const char* name = (argc >= 5 ? argv[4] : "greedy");
+		if (!withPolicy(name, 1, [&](auto& policy) {
+				SurvivalEstimate e = runner.estimate(policy, atoi(argv[2]), halfWidth);
+				cout << "Survived " << e.survived << " of " << e.games << " games: "
+					<< e.rate << " (95% interval " << e.low << " to " << e.high << ")" << endl;
+				if (!e.converged)
+					cout << "The interval is still wider than asked for." << endl;
+			}))
+		{
+			cout << "***** " << name << " is not a policy (greedy, random or search)!" << endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	// Create a game
+	// Use this instead to create a mini-game:   Game g(3, 3, 2);
+	// Or this for snakes that hunt the player: Game g(9, 10, 15, true);
+	Game g(9, 10, 15);
+
+	// snakepit --autoplay [ms per turn] [greedy|random|search]: watch
+	// the computer play in real time
+	if (argc >= 2 && strcmp(argv[1], "--autoplay") == 0)
+	{
+		Renderer preview(cout, true);
+		int msPerTurn = (argc >= 3 ? atoi(argv[2]) : 200);
+		const char* name = (argc >= 4 ? argv[3] : "greedy");
+		if (!withPolicy(name, time(0), [&](auto& policy) {
+				g.autoplay(policy, 10000, msPerTurn, &preview);
+			}))
+		{
+			cout << "***** " << name << " is not a policy (greedy, random or search)!" << endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	// snakepit --heatmaps [greedy|random|search]: play, or let the
+	// computer play, while Analytics counts visits and deaths in each
+	// cell, then show where they happened
+	if (argc >= 2 && strcmp(argv[1], "--heatmaps") == 0)
+	{
+		const int BUCKETTURNS = 100;
+		const int NBUCKETS = 101;  // enough for the last 10000 turns
+		Analytics analytics(g.pit()->rows(), g.pit()->cols(), BUCKETTURNS, NBUCKETS);
+		g.pit()->recordTo(&analytics);
+		if (argc < 3)
+			g.play();
+		else if (!withPolicy(argv[2], time(0), [&](auto& policy) { g.run(policy, 10000); }))
+		{
+			cout << "***** " << argv[2] << " is not a policy (greedy, random or search)!" << endl;
+			return 1;
+		}
+		g.pit()->recordTo(nullptr);
+		static const char* const names[NUMHEATMAPS] = { "Visits", "Snakes killed", "Player deaths" };
+		int toTurn = analytics.turn();
+		int fromTurn = (toTurn > (NBUCKETS - 1) * BUCKETTURNS ? toTurn - (NBUCKETS - 1) * BUCKETTURNS : 0);
+		for (int kind = 0; kind < NUMHEATMAPS; kind++)
+		{
+			cout << names[kind] << ", turns " << fromTurn << " to " << toTurn << ":" << endl;
+			analytics.render(cout, kind, fromTurn, toTurn);
+		}
+		return 0;
+	}
+
+	// snakepit --checkpoint <file>: resume the game saved in the file,
+	// if there is one, and save it there again on quitting; a game that
+	// ended leaves no checkpoint behind
+	if (argc >= 3 && strcmp(argv[1], "--checkpoint") == 0)
+	{
+		if (g.restore(argv[2]))
+			cout << "Resuming the game saved in " << argv[2] << "." << endl;
+		g.play();
+		const Player* p = g.pit()->player();
+		if (p->isDead() || g.pit()->snakeCount() == 0)
+			remove(argv[2]);
+		else if (!g.save(argv[2]))
+		{
+			cout << "***** Could not save the game to " << argv[2] << "!" << endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	// snakepit --record <file>: write every frame shown to the file, for
+	// --replay
+	if (argc >= 3 && strcmp(argv[1], "--record") == 0)
+	{
+		FrameWriter recorder(argv[2]);
+		if (!recorder.isOpen())
+		{
+			cout << "***** Could not record the game to " << argv[2] << "!" << endl;
+			return 1;
+		}
+		g.pit()->recordFramesTo(&recorder);
+		g.play();
+		g.pit()->recordFramesTo(nullptr);
+		recorder.close();
+		if (recorder.failed())
+		{
+			cout << "***** Recording to " << argv[2] << " failed after "
+				<< recorder.framesWritten() << " frames!" << endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	// snakepit --publish <name>: let --watch processes see this game
+	SharedState* spectators = nullptr;
+	if (argc >= 3 && strcmp(argv[1], "--publish") == 0)
+	{
+		spectators = new SharedState(argv[2], true);
+		g.pit()->publishTo(spectators);
+	}
+
+	// Play the game
+	g.play();
+	g.pit()->publishTo(nullptr);
+	delete spectators;
+}
+
+
+/*
+#include "History.h"
+int main()
+{
+	History h;
+}
+*/
+
+/*#include "globals.h"
+#include "Snake.h"
+#include "Player.h"
+int main()
+{
+	Pit pt(10, 10);
+}
+*/
+
+/*
+#include "Player.h"
+#include "Pit.h"
+int main()
+{
+	Pit pt(10, 20);
+	Player p(&pt, 2, 3);
+	Snake s(&pt, 1, 1);
+}
+*/
+
+/*
+#include "Pit.h"
+#include "History.h"
+#include "Player.h"
+#include "globals.h"
+int main()
+{
+	Pit pt(3, 3);
+	pt.addPlayer(1, 1);
+	pt.addSnake(1, 2);
+	pt.addSnake(2, 2);
+	pt.addSnake(2, 3);
+	pt.player()->move(RIGHT);
+	pt.player()->move(LEFT);
+	pt.player()->move(DOWN);
+	pt.player()->move(RIGHT);
+	pt.player()->move(UP);
+	pt.history().display();
+}
+*/
+
+/*
+#include "Player.h"
+#include "Pit.h"
+int main()
+{
+	Pit pt(10, 20);
+	Player p(&pt, 2, 3);
+}
+*/
+
+/*
+#include "Pit.h"
+#include "Player.h"
+int main()
+{
+	Pit pt(10, 20);
+	Player p(&pt, 2, 3);
+}
+*/
+
+/*
+#include "globals.h"
+#include "Player.h"
+#include "Pit.h"
+int main()
+{
+	Pit pt(10, 20);
+	Player p(&pt, 2, 3);
+}
+*/
+
+/*
+#include "Pit.h"
+int main()
+{
+	Pit pt(10, 18);
+	pt.addPlayer(2, 2);
+}
+*/
+
+/*
+#include "Player.h"
+int main()
+{
+	Player p(nullptr, 1, 1);
+}
+*/
+
+/*
+#include "Snake.h"
+int main()
+{
+	Snake s(nullptr, 1, 1);
+}
+*/
+
+/*
+#include "History.h"
+int main()
+{
+	History h(2, 2);
+	for (int i = 0; i < 100; i++)
+		h.record(1, 1);
+	for (int i = 0; i < 3; i++)
+		h.record(1, 2);
+	for (int i = 0; i < 7; i++)
+		h.record(2, 1);
+	for (int i = 0; i < 18; i++)
+		h.record(2, 2);
+	h.display();
+}
+*/
+
+/*
+#include "Game.h"
+#include "Game.h"
+#include "Pit.h"
+#include "Pit.h"
+#include "History.h"
+#include "History.h"
+#include "Player.h"
+#include "Player.h"
+#include "Snake.h"
+#include "Snake.h"
+#include "globals.h"
+#include "globals.h"
+int main()
+{}
+*/
+
@@ -0,0 +1,654 @@
+// Checks of the pit-level features.  Each compares against a plain
+// reference or against a second way of reaching the same state, and
+// uses fixed seeds so any failure reproduces.  Build and run with
+//     g++ -std=c++20 -pthread -o tests tests.cpp <the .cpp files in README.md>
+//     ./tests
+// Each failed check is printed; the exit status is 1 if any failed.
+
+#include "Pit.h"
+#include "Player.h"
+#include "History.h"
+#include "GlobalHistory.h"
+#include "FixedPit.h"
+#include "PitFactory.h"
+#include "Policy.h"
+#include "Snapshot.h"
+#include "Journal.h"
+#include "CompactGame.h"
+#include "BatchEnv.h"
+#include "globals.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+using namespace std;
+
+namespace
+{
+	int checks = 0;
+	int failures = 0;
+
+	void check(bool ok, const string& what)
+	{
+		checks++;
+		if (!ok)
+		{
+			cout << "***** FAILED: " << what << endl;
+			failures++;
+		}
+	}
+
+	// What the two kinds of pit have in common: the first player and
+	// the number of snakes in each cell, as text
+	template <typename PitType>
+	string stateOf(PitType& pit)
+	{
+		ostringstream out;
+		out << pit.rows() << "x" << pit.cols() << ", " << pit.snakeCount() << " snakes";
+		if (pit.player() != nullptr)
+			out << ", player at " << pit.player()->row() << "," << pit.player()->col()
+				<< " age " << pit.player()->age() << (pit.player()->isDead() ? " dead" : "");
+		out << endl;
+		for (int r = 1; r <= pit.rows(); r++)
+		{
+			for (int c = 1; c <= pit.cols(); c++)
+				out << pit.numberOfSnakesAt(r, c) << ' ';
+			out << endl;
+		}
+		return out.str();
+	}
+
+	// All of a Pit's game state but its generator: stateOf plus the
+	// turn, every player and the kill history
+	string fullStateOf(Pit& pit)
+	{
+		ostringstream out;
+		out << stateOf(pit) << "turn " << pit.turn() << (pit.isHunting() ? " hunting" : "") << endl;
+		for (int k = 0; k < pit.playerCount(); k++)
+		{
+			const Player* p = pit.player(k);
+			out << "player " << p->row() << "," << p->col() << " age " << p->age()
+				<< (p->isDead() ? " dead" : "") << endl;
+		}
+		for (int r = 1; r <= pit.rows(); r++)
+		{
+			for (int c = 1; c <= pit.cols(); c++)
+				out << pit.history().timesAt(r, c) << ' ';
+			out << endl;
+		}
+		return out.str();
+	}
+
+	template <typename PitType>
+	bool isOver(PitType& pit)
+	{
+		return pit.player() == nullptr || pit.player()->isDead() || pit.snakeCount() == 0;
+	}
+
+	// One turn for the first player: the move (STAND or a direction),
+	// then the snakes
+	template <typename PitType>
+	void playTurn(PitType& pit, int move)
+	{
+		if (move == STAND)
+			pit.player()->stand();
+		else
+			pit.player()->move(move);
+		pit.moveSnakes();
+	}
+
+	//*****************************************************************
+	//  Pit::dangerMap
+	//*****************************************************************
+
+	void testDangerMap()
+	{
+		// dangerMap must give dangerAt's probability for every cell,
+		// with and without hunting, on crowded and sparse pits alike
+		const int sizes[][3] = { { 3, 3, 2 }, { 9, 10, 15 }, { 20, 40, 180 }, { 1, 40, 20 }, { 20, 1, 10 } };
+		for (const auto& size : sizes)
+		{
+			for (int hunting = 0; hunting <= 1; hunting++)
+			{
+				for (unsigned long long seed = 1; seed <= 5; seed++)
+				{
+					Pit pit(size[0], size[1], seed);
+					if (!startPit(pit, size[2], hunting != 0, seed))
+					{
+						check(false, "startPit for the dangerMap check");
+						continue;
+					}
+					RandomPolicy policy;
+					policy.start(seed);
+					for (int turn = 0; turn < 20 && !isOver(pit); turn++)
+					{
+						float danger[MAXROWS][MAXCOLS];
+						pit.dangerMap(danger);
+						bool same = true;
+						for (int r = 1; r <= pit.rows(); r++)
+							for (int c = 1; c <= pit.cols(); c++)
+								same = same && fabs(danger[r - 1][c - 1] - pit.dangerAt(r, c)) < 1e-6;
+						ostringstream what;
+						what << "dangerMap matches dangerAt on a " << size[0] << "x" << size[1]
+							<< (hunting ? " hunting" : "") << " pit, seed " << seed << ", turn " << turn;
+						check(same, what.str());
+						playTurn(pit, policy.choose(pit));
+					}
+				}
+			}
+		}
+	}
+
+	//*****************************************************************
+	//  History and GlobalHistory
+	//*****************************************************************
+
+	void testHistory()
+	{
+		// Record kills at random cells and one cell past saturation, and
+		// take some back, checking every count against a plain grid
+		// as History goes from sparse to dense
+		const int rows = 20;
+		const int cols = 40;
+		History h(rows, cols);
+		int counts[rows][cols] = { };
+		Pit dice(1, 1, 1);  // just for its generator
+		bool wasSparse = !h.isDense();
+		for (int k = 0; k < 3000; k++)
+		{
+			int r = 1 + dice.randInt(k < 1000 ? 2 : rows);  // the first kills pile up in two rows
+			int c = 1 + dice.randInt(cols);
+			int before = counts[r - 1][c - 1];
+			check(h.record(r, c), "History::record inside the grid");
+			if (counts[r - 1][c - 1] < MAXKILLCOUNT)
+				counts[r - 1][c - 1]++;
+			if (k % 7 == 0)
+			{
+				h.unrecord(r, c, before);
+				counts[r - 1][c - 1] = before;
+			}
+		}
+		for (int k = 0; k < 300; k++)
+		{
+			h.record(1, 1);
+			if (counts[0][0] < MAXKILLCOUNT)
+				counts[0][0]++;
+		}
+		check(!h.record(0, 1) && !h.record(rows + 1, 1) && !h.record(1, cols + 1),
+			"History::record outside the grid");
+		check(wasSparse && h.isDense(), "History starts sparse and ends up dense");
+		bool same = true;
+		bool saturated = false;
+		for (int r = 1; r <= rows; r++)
+			for (int c = 1; c <= cols; c++)
+			{
+				same = same && h.timesAt(r, c) == counts[r - 1][c - 1];
+				saturated = saturated || counts[r - 1][c - 1] == MAXKILLCOUNT;
+			}
+		check(same, "History counts match a plain grid");
+		check(saturated, "History counts saturate at MAXKILLCOUNT");
+
+		// exportCounts and importCounts round-trip, in both forms
+		unsigned char bytes[rows * cols];
+		h.exportCounts(bytes);
+		History copy(rows, cols);
+		copy.importCounts(bytes);
+		same = copy.isDense();
+		for (int r = 1; r <= rows; r++)
+			for (int c = 1; c <= cols; c++)
+				same = same && copy.timesAt(r, c) == counts[r - 1][c - 1];
+		check(same, "History import of a dense export");
+		History sparse(rows, cols);
+		sparse.record(3, 4);
+		sparse.record(3, 4);
+		sparse.record(20, 40);
+		sparse.exportCounts(bytes);
+		copy.importCounts(bytes);
+		check(!copy.isDense() && copy.timesAt(3, 4) == 2 && copy.timesAt(20, 40) == 1 &&
+			copy.timesAt(1, 1) == 0, "History import of a sparse export");
+
+		// The thread's GlobalHistory buffer sees records and unrecords
+		GlobalHistory global;
+		History::setThreadTotals(global.newBuffer());
+		History g(rows, cols);
+		for (int k = 0; k < 5; k++)
+			g.record(2, 3);
+		g.unrecord(2, 3, 4);
+		g.record(20, 40);
+		History::setThreadTotals(nullptr);
+		g.record(2, 3);  // not counted: no buffer any more
+		global.merge();
+		check(global.timesAt(2, 3) == 4 && global.timesAt(20, 40) == 1 && global.timesAt(1, 1) == 0,
+			"GlobalHistory totals follow record and unrecord");
+	}
+
+	//*****************************************************************
+	//  FixedPit
+	//*****************************************************************
+
+	template <int Rows, int Cols>
+	void testFixedPitParity(int nSnakes)
+	{
+		// The same seed and moves must give the same game on a FixedPit
+		// as on a Pit, turn by turn
+		for (int hunting = 0; hunting <= 1; hunting++)
+		{
+			for (unsigned long long seed = 1; seed <= 20; seed++)
+			{
+				Pit pit(Rows, Cols, seed);
+				FixedPit<Rows, Cols, MAXSNAKES> fixed;
+				if (!startPit(pit, nSnakes, hunting != 0, seed) ||
+					!startPit(fixed, nSnakes, hunting != 0, seed))
+				{
+					check(false, "startPit for the FixedPit check");
+					continue;
+				}
+				RandomPolicy policy;
+				policy.start(seed);
+				int turn = 0;
+				for (; turn < 200 && stateOf(pit) == stateOf(fixed) && !isOver(pit); turn++)
+				{
+					int move = policy.choose(pit);
+					playTurn(pit, move);
+					playTurn(fixed, move);
+				}
+				ostringstream what;
+				what << "FixedPit<" << Rows << "," << Cols << "> plays as Pit"
+					<< (hunting ? " hunting" : "") << ", seed " << seed << ", turn " << turn;
+				check(stateOf(pit) == stateOf(fixed), what.str());
+			}
+		}
+	}
+
+	//*****************************************************************
+	//  CompactGame
+	//*****************************************************************
+
+	// A CompactGame's state in stateOf's form, plus its kill counts
+	string stateOf(CompactGame& game)
+	{
+		ostringstream out;
+		out << game.rows() << "x" << game.cols() << ", " << game.snakeCount() << " snakes"
+			<< ", player at " << game.row() << "," << game.col()
+			<< " age " << game.age() << (game.isDead() ? " dead" : "") << endl;
+		for (int r = 1; r <= game.rows(); r++)
+		{
+			for (int c = 1; c <= game.cols(); c++)
+				out << game.numberOfSnakesAt(r, c) << ' ';
+			out << endl;
+		}
+		for (int r = 1; r <= game.rows(); r++)
+		{
+			for (int c = 1; c <= game.cols(); c++)
+				out << game.killsAt(r, c) << ' ';
+			out << endl;
+		}
+		return out.str();
+	}
+
+	string killsOf(Pit& pit)
+	{
+		ostringstream out;
+		for (int r = 1; r <= pit.rows(); r++)
+		{
+			for (int c = 1; c <= pit.cols(); c++)
+				out << pit.history().timesAt(r, c) << ' ';
+			out << endl;
+		}
+		return out.str();
+	}
+
+	void testCompactGame()
+	{
+		// From the same seed and with the same moves, a CompactGame must
+		// play the game a Pit does, with the same observations
+		const int sizes[][3] = { { 3, 3, 2 }, { 9, 10, 15 }, { 10, 10, 60 }, { 1, 40, 20 }, { 5, 20, 99 } };
+		for (const auto& size : sizes)
+		{
+			for (int hunting = 0; hunting <= 1; hunting++)
+			{
+				for (unsigned long long seed = 1; seed <= 20; seed++)
+				{
+					Pit pit(size[0], size[1], seed);
+					startPitOrExit(pit, size[2], hunting != 0, seed);
+					CompactGame game(size[0], size[1], size[2], seed, hunting != 0);
+					RandomPolicy policy;
+					policy.start(seed);
+					int cells = size[0] * size[1];
+					unsigned char pitObs[NUMOBSPLANES * MAXCOMPACTCELLS];
+					unsigned char gameObs[NUMOBSPLANES * MAXCOMPACTCELLS];
+					bool same = true;
+					int turn = 0;
+					for (; turn < 200 && same; turn++)
+					{
+						pit.exportObservation(pitObs, cells, size[1]);
+						game.exportObservation(gameObs, cells, size[1]);
+						same = (stateOf(game) == stateOf(pit) + killsOf(pit) &&
+							equal(pitObs, pitObs + NUMOBSPLANES * cells, gameObs));
+						if (isOver(pit))
+							break;
+						int move = policy.choose(pit);
+						playTurn(pit, move);
+						game.takeTurn(move);
+					}
+					ostringstream what;
+					what << "CompactGame plays as Pit on a " << size[0] << "x" << size[1]
+						<< (hunting ? " hunting" : "") << " pit, seed " << seed << ", turn " << turn;
+					check(same, what.str());
+				}
+			}
+		}
+	}
+
+	void testBatchEnv()
+	{
+		// Each env of the batch must play the game a Pit started from
+		// that env's seed does, whether the batch runs CompactGames (the
+		// 9x10 pit) or Pits (the 20x40 one); a finished game restarts
+		// from the env's next seed
+		const int sizes[][3] = { { 9, 10, 15 }, { 20, 40, 40 } };
+		const int nEnvs = 8;
+		for (const auto& size : sizes)
+		{
+			for (int hunting = 0; hunting <= 1; hunting++)
+			{
+				check(snakepit_configure(size[0], size[1], size[2], hunting) != 0, "snakepit_configure");
+				int obsSize = snakepit_obs_size();
+				vector<unsigned char> obs(static_cast<size_t>(nEnvs) * obsSize);
+				vector<unsigned char> pitObs(obsSize);
+				vector<unsigned long long> seeds(nEnvs);
+				vector<Pit*> pits(nEnvs);
+				vector<RandomPolicy> policies(nEnvs);
+				for (int k = 0; k < nEnvs; k++)
+				{
+					seeds[k] = 100 + k;
+					pits[k] = new Pit(size[0], size[1], seeds[k]);
+					startPitOrExit(*pits[k], size[2], hunting != 0, seeds[k]);
+					policies[k].start(seeds[k]);
+				}
+				check(snakepit_reset(nEnvs, seeds.data(), obs.data()) != 0, "snakepit_reset");
+				vector<int> actions(nEnvs);
+				vector<float> rewards(nEnvs);
+				vector<unsigned char> dones(nEnvs);
+				int games = 0;
+				bool same = true;
+				int step = 0;
+				for (; step < 300 && same; step++)
+				{
+					for (int k = 0; k < nEnvs && same; k++)
+					{
+						pits[k]->exportObservation(pitObs.data(), size[0] * size[1], size[1]);
+						same = equal(pitObs.begin(), pitObs.end(), obs.begin() + static_cast<size_t>(k) * obsSize);
+					}
+					for (int k = 0; k < nEnvs; k++)
+						actions[k] = policies[k].choose(*pits[k]);
+					snakepit_step(actions.data(), obs.data(), rewards.data(), dones.data());
+					for (int k = 0; k < nEnvs && same; k++)
+					{
+						Pit* pit = pits[k];
+						int before = pit->snakeCount();
+						playTurn(*pit, actions[k]);
+						float reward = static_cast<float>(before - pit->snakeCount()) -
+							(pit->player()->isDead() ? 1 : 0);
+						same = (rewards[k] == reward && (dones[k] != 0) == isOver(*pit));
+						if (isOver(*pit))
+						{
+							delete pit;
+							seeds[k] = seeds[k] * 6364136223846793005ULL + 1442695040888963407ULL;
+							pits[k] = new Pit(size[0], size[1], seeds[k]);
+							startPitOrExit(*pits[k], size[2], hunting != 0, seeds[k]);
+							games++;
+						}
+					}
+				}
+				for (Pit* pit : pits)
+					delete pit;
+				ostringstream what;
+				what << "BatchEnv plays as Pit on a " << size[0] << "x" << size[1]
+					<< (hunting ? " hunting" : "") << " pit, step " << step;
+				check(same, what.str());
+				check(games > 0, what.str() + " restarts finished games");
+			}
+		}
+		snakepit_close();
+	}
+
+	//*****************************************************************
+	//  Morton resorting
+	//*****************************************************************
+
+	// Whether every snake can be found through the pit's cell lists:
+	// on a copy, kill them all one at a time, cell by cell
+	bool killsEverySnake(const Pit& pit)
+	{
+		Pit copy(pit);
+		for (int r = 1; r <= copy.rows(); r++)
+			for (int c = 1; c <= copy.cols(); c++)
+				for (int n = copy.numberOfSnakesAt(r, c); n > 0; n--)
+				{
+					int before = copy.snakeCount();
+					if (!copy.hasSnakeAt(r, c) || !copy.destroyOneSnake(r, c) ||
+						copy.numberOfSnakesAt(r, c) != n - 1 || copy.snakeCount() != before - 1)
+						return false;
+				}
+		return copy.snakeCount() == 0;
+	}
+
+	void testResort()
+	{
+		// Resorting only reorders the snakes in memory, so every turn of
+		// a resorting pit must end as it does on a copy that doesn't
+		// resort, and the snakes must all still be where the pit thinks
+		const int interval = 4;
+		const int sizes[][3] = { { 9, 10, 15 }, { 20, 40, 180 } };
+		for (const auto& size : sizes)
+		{
+			for (unsigned long long seed = 1; seed <= 5; seed++)
+			{
+				Pit pit(size[0], size[1], seed);
+				startPitOrExit(pit, size[2], false, seed);
+				pit.setResortInterval(interval);
+				GreedyPolicy policy;
+				bool same = true;
+				bool found = true;
+				for (int turn = 0; turn < 100 && !isOver(pit) && same && found; turn++)
+				{
+					Pit unsorted(pit);
+					unsorted.setResortInterval(0);
+					int move = policy.choose(pit);
+					playTurn(pit, move);
+					playTurn(unsorted, move);
+					same = (fullStateOf(pit) == fullStateOf(unsorted));
+					if (pit.turn() % interval == 0)
+						found = killsEverySnake(pit);
+				}
+				ostringstream what;
+				what << "Morton resort on a " << size[0] << "x" << size[1] << " pit, seed " << seed;
+				check(same, what.str() + " leaves each turn's state as it was");
+				check(found, what.str() + " keeps the cell lists whole");
+			}
+		}
+	}
+
+	//*****************************************************************
+	//  Pit::advance
+	//*****************************************************************
+
+	void testAdvance()
+	{
+		// advance(n) must leave the pit, generator included, exactly as
+		// n turns of standing would, stopping on the same turn if the
+		// player dies; then both pits play on alike
+		const int sizes[][3] = { { 3, 3, 2 }, { 9, 10, 15 }, { 20, 40, 40 }, { 20, 40, 180 } };
+		const int steps[] = { 1, 3, 17, 64, 500 };
+		for (const auto& size : sizes)
+		{
+			for (int hunting = 0; hunting <= 1; hunting++)
+			{
+				for (int n : steps)
+				{
+					for (unsigned long long seed = 1; seed <= 5; seed++)
+					{
+						Pit fused(size[0], size[1], seed);
+						Pit stepped(size[0], size[1], seed);
+						startPitOrExit(fused, size[2], hunting != 0, seed);
+						startPitOrExit(stepped, size[2], hunting != 0, seed);
+						int taken = fused.advance(n);
+						int turns = 0;
+						while (turns < n && !isOver(stepped))
+						{
+							playTurn(stepped, STAND);
+							turns++;
+						}
+						GreedyPolicy policy;
+						for (int turn = 0; turn < 20 && !isOver(fused); turn++)
+						{
+							int move = policy.choose(fused);
+							playTurn(fused, move);
+							playTurn(stepped, move);
+						}
+						ostringstream what;
+						what << "advance(" << n << ") on a " << size[0] << "x" << size[1]
+							<< (hunting ? " hunting" : "") << " pit, seed " << seed;
+						check(taken == turns, what.str() + " takes as many turns as standing");
+						check(fullStateOf(fused) == fullStateOf(stepped), what.str() + " ends as standing does");
+					}
+				}
+			}
+		}
+	}
+
+	//*****************************************************************
+	//  Undo
+	//*****************************************************************
+
+	void testUndo()
+	{
+		// Playing n turns and undoing them must give back the pit as it
+		// was, generator included.  Extra players who only stand now and
+		// then, and die when a snake finds them, check that players are
+		// put back from just what they changed.
+		const int n = 40;
+		for (int hunting = 0; hunting <= 1; hunting++)
+		{
+			for (unsigned long long seed = 1; seed <= 10; seed++)
+			{
+				Pit pit(9, 10, seed);
+				startPitOrExit(pit, 15, hunting != 0, seed);
+				for (int k = 0; k < 4; k++)
+					pit.addPlayer(1 + pit.randInt(9), 1 + pit.randInt(10));
+				Journal journal(n);
+				pit.journalTo(&journal);
+				GreedyPolicy policy;
+				for (int turn = 0; turn < 10 && !isOver(pit); turn++)  // turns before the snapshot
+				{
+					pit.markTurn();
+					playTurn(pit, policy.choose(pit));
+				}
+				Pit before(pit);
+				string state = fullStateOf(pit);
+				int played = 0;
+				for (; played < n && !isOver(pit); played++)
+				{
+					pit.markTurn();
+					for (int k = 1; k < pit.playerCount(); k++)
+						if (played % (k + 1) == k && !pit.player(k)->isDead())
+							pit.player(k)->stand();
+					playTurn(pit, policy.choose(pit));
+				}
+				int undone = 0;
+				while (undone < played && pit.undoTurn())
+					undone++;
+				ostringstream what;
+				what << "undo of " << played << " turns" << (hunting ? " hunting" : "") << ", seed " << seed;
+				check(undone == played, what.str() + " takes them all back");
+				check(fullStateOf(pit) == state, what.str() + " gives back the state");
+				pit.journalTo(nullptr);
+				for (int turn = 0; turn < 30 && !isOver(before); turn++)
+				{
+					int move = policy.choose(before);
+					playTurn(before, move);
+					playTurn(pit, move);
+				}
+				check(fullStateOf(pit) == fullStateOf(before), what.str() + " gives back the generator");
+			}
+		}
+	}
+
+	//*****************************************************************
+	//  Snapshot
+	//*****************************************************************
+
+	void testSnapshot()
+	{
+		// A loaded pit must have the saved pit's state, generator
+		// included: both play on identically
+		const string path = "tests.snapshot";
+		for (unsigned long long seed = 1; seed <= 5; seed++)
+		{
+			Pit pit(9, 10, seed);
+			startPitOrExit(pit, 15, seed % 2 == 0, seed);
+			GreedyPolicy policy;
+			for (int turn = 0; turn < 30 && !isOver(pit); turn++)
+				playTurn(pit, policy.choose(pit));
+			check(Snapshot::save(pit, path), "Snapshot::save");
+			Pit* loaded = Snapshot::load(path);
+			check(loaded != nullptr, "Snapshot::load of a saved pit");
+			if (loaded == nullptr)
+				continue;
+			ostringstream what;
+			what << "Snapshot round trip, seed " << seed;
+			check(fullStateOf(*loaded) == fullStateOf(pit), what.str());
+			for (int turn = 0; turn < 30 && !isOver(pit); turn++)
+			{
+				int move = policy.choose(pit);
+				playTurn(pit, move);
+				playTurn(*loaded, move);
+			}
+			check(fullStateOf(*loaded) == fullStateOf(pit), what.str() + ", 30 turns on");
+			delete loaded;
+		}
+
+		// A damaged file is refused
+		Pit pit(9, 10, 1);
+		startPitOrExit(pit, 15, false, 1);
+		Snapshot::save(pit, path);
+		FILE* f = fopen(path.c_str(), "r+b");
+		if (f != nullptr)
+		{
+			fseek(f, -1, SEEK_END);
+			int last = fgetc(f);
+			fseek(f, -1, SEEK_END);
+			fputc(last ^ 1, f);
+			fclose(f);
+		}
+		Pit* loaded = Snapshot::load(path);
+		check(loaded == nullptr, "Snapshot::load refuses a damaged file");
+		delete loaded;
+		remove(path.c_str());
+	}
+}
+
+int main()
+{
+	testDangerMap();
+	testHistory();
+	testFixedPitParity<9, 10>(15);
+	testFixedPitParity<3, 3>(2);
+	testCompactGame();
+	testBatchEnv();
+	testResort();
+	testAdvance();
+	testUndo();
+	testSnapshot();
+	if (failures > 0)
+	{
+		cout << failures << " of " << checks << " checks failed." << endl;
+		return 1;
+	}
+	cout << "All " << checks << " checks passed." << endl;
+	return 0;
+}
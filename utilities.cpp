@@ -1,73 +1,74 @@
-#include "globals.h"
-#include <iostream>
-
-int decodeDirection(char dir)
-{
-	switch (dir)
-	{
-	case 'u':  return UP;
-	case 'd':  return DOWN;
-	case 'l':  return LEFT;
-	case 'r':  return RIGHT;
-	}
-	return -1;  // bad argument passed in!
-}
-
-bool directionToDeltas(int dir, int& rowDelta, int& colDelta)
-{
-	switch (dir)
-	{
-	case UP:     rowDelta = -1; colDelta = 0; break;
-	case DOWN:   rowDelta = 1; colDelta = 0; break;
-	case LEFT:   rowDelta = 0; colDelta = -1; break;
-	case RIGHT:  rowDelta = 0; colDelta = 1; break;
-	default:     return false;
-	}
-	return true;
-}
-
-///////////////////////////////////////////////////////////////////////////
-//  clearScreen implementations
-///////////////////////////////////////////////////////////////////////////
-
-// DO NOT MODIFY THE CODE BETWEEN HERE AND THE END OF THE FILE!!!
-// THE CODE IS SUITABLE FOR VISUAL C++, XCODE, AND g++ UNDER LINUX.
-
-// Note to Xcode users:  clearScreen() will just write a newline instead
-// of clearing the window if you launch your program from within Xcode.
-// That's acceptable.
-
-#ifdef _MSC_VER  //  Microsoft Visual C++
-
-#include <windows.h>
-
-void clearScreen()
-{
-	HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-	CONSOLE_SCREEN_BUFFER_INFO csbi;
-	GetConsoleScreenBufferInfo(hConsole, &csbi);
-	DWORD dwConSize = csbi.dwSize.X * csbi.dwSize.Y;
-	COORD upperLeft = { 0, 0 };
-	DWORD dwCharsWritten;
-	FillConsoleOutputCharacter(hConsole, TCHAR(' '), dwConSize, upperLeft,
-		&dwCharsWritten);
-	SetConsoleCursorPosition(hConsole, upperLeft);
-}
-
-#else  // not Microsoft Visual C++, so assume UNIX interface
-
-#include <cstring>
-
-void clearScreen()  // will just write a newline in an Xcode output window
-{
-	static const char* term = getenv("TERM");
-	if (term == nullptr || strcmp(term, "dumb") == 0)
-		cout << endl;
-	else
-	{
-		static const char* ESC_SEQ = "\x1B[";  // ANSI Terminal esc seq:  ESC [
-		cout << ESC_SEQ << "2J" << ESC_SEQ << "H" << flush;
-	}
-}
-
+#include "globals.h"
+#include <iostream>
+using namespace std;
+
+int decodeDirection(char dir)
+{
+	switch (dir)
+	{
+	case 'u':  return UP;
+	case 'd':  return DOWN;
+	case 'l':  return LEFT;
+	case 'r':  return RIGHT;
+	}
+	return -1;  // bad argument passed in!
+}
+
+bool directionToDeltas(int dir, int& rowDelta, int& colDelta)
+{
+	switch (dir)
+	{
+	case UP:     rowDelta = -1; colDelta = 0; break;
+	case DOWN:   rowDelta = 1; colDelta = 0; break;
+	case LEFT:   rowDelta = 0; colDelta = -1; break;
+	case RIGHT:  rowDelta = 0; colDelta = 1; break;
+	default:     return false;
+	}
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+//  clearScreen implementations
+///////////////////////////////////////////////////////////////////////////
+
+// DO NOT MODIFY THE CODE BETWEEN HERE AND THE END OF THE FILE!!!
+// THE CODE IS SUITABLE FOR VISUAL C++, XCODE, AND g++ UNDER LINUX.
+
+// Note to Xcode users:  clearScreen() will just write a newline instead
+// of clearing the window if you launch your program from within Xcode.
+// That's acceptable.
+
+#ifdef _MSC_VER  //  Microsoft Visual C++
+
+#include <windows.h>
+
+void clearScreen()
+{
+	HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+	CONSOLE_SCREEN_BUFFER_INFO csbi;
+	GetConsoleScreenBufferInfo(hConsole, &csbi);
+	DWORD dwConSize = csbi.dwSize.X * csbi.dwSize.Y;
+	COORD upperLeft = { 0, 0 };
+	DWORD dwCharsWritten;
+	FillConsoleOutputCharacter(hConsole, TCHAR(' '), dwConSize, upperLeft,
+		&dwCharsWritten);
+	SetConsoleCursorPosition(hConsole, upperLeft);
+}
+
+#else  // not Microsoft Visual C++, so assume UNIX interface
+
+#include <cstring>
+
+void clearScreen()  // will just write a newline in an Xcode output window
+{
+	static const char* term = getenv("TERM");
+	if (term == nullptr || strcmp(term, "dumb") == 0)
+		cout << endl;
+	else
+	{
+		static const char* ESC_SEQ = "\x1B[";  // ANSI Terminal esc seq:  ESC [
+		cout << ESC_SEQ << "2J" << ESC_SEQ << "H" << flush;
+	}
+}
+
 #endif
\ No newline at end of file